@@ -66,7 +66,7 @@ set mlton=%lib%\mlton-compile.exe
 set ccopts=-O1 -fno-strict-aliasing -fomit-frame-pointer -w
 set ccopts=%ccopts% -fno-strength-reduce -fschedule-insns -fschedule-insns2
 set ccopts=%ccopts% -malign-functions=5 -malign-jumps=2 -malign-loops=2
-set linkopts=-lm -lgmp -lws2_32 -lkernel32 -lpsapi -lnetapi32 -lwinmm -Wl,--enable-stdcall-fixup -Wl,-s
+set linkopts=-lm -lgmp -lpthread -lws2_32 -lkernel32 -lpsapi -lnetapi32 -lwinmm -Wl,--enable-stdcall-fixup -Wl,-s
 
 "%mlton%" @MLton ram-slop 0.5 %rargs% -- "%lib%" -cc "%cc%" -ar-script "%lib%\static-library.bat" -cc-opt-quote "-I%lib%\include" -cc-opt "%ccopts%" -mlb-path-map "%lib%\mlb-path-map" -link-opt "%linkopts%" %args%
 set retval=%errorlevel%
@@ -26,12 +26,14 @@ make install DESTDIR=$RPM_BUILD_ROOT VERSION=%{version}
 
 %files
 %attr(-, root, root)		/usr/share/doc/mlton
+%attr(-, root, root)		/usr/bin/mlheap
 %attr(-, root, root)		/usr/bin/mllex
 %attr(-, root, root)		/usr/bin/mlnlffigen
 %attr(-, root, root)		/usr/bin/mlprof
 %attr(-, root, root)		/usr/bin/mlton
 %attr(-, root, root)		/usr/bin/mlyacc
 %attr(-, root, root)		/usr/lib/mlton
+%attr(-, root, root)		/usr/man/man1/mlheap.1.gz
 %attr(-, root, root)		/usr/man/man1/mllex.1.gz
 %attr(-, root, root)		/usr/man/man1/mlnlffigen.1.gz
 %attr(-, root, root)		/usr/man/man1/mlprof.1.gz
@@ -24,17 +24,21 @@
 #include "gc/align.c"
 #include "gc/read_write.c"
 
+#include "gc/adaptive-nursery.c"
+#include "gc/alloc-sample.c"
 #include "gc/array-allocate.c"
 #include "gc/array.c"
 #include "gc/atomic.c"
 #include "gc/call-stack.c"
 #include "gc/cheney-copy.c"
+#include "gc/concurrent-mark.c"
 #include "gc/controls.c"
 #include "gc/copy-thread.c"
 #include "gc/current.c"
 #include "gc/dfs-mark.c"
 #include "gc/done.c"
 #include "gc/enter_leave.c"
+#include "gc/event-log.c"
 #include "gc/foreach.c"
 #include "gc/forward.c"
 #include "gc/frame.c"
@@ -43,29 +47,41 @@
 #include "gc/generational.c"
 #include "gc/handler.c"
 #include "gc/hash-cons.c"
+#include "gc/heap-census.c"
+#include "gc/heap-dump.c"
 #include "gc/heap.c"
 #include "gc/heap_predicates.c"
 #include "gc/init-world.c"
 #include "gc/init.c"
 #include "gc/int-inf.c"
 #include "gc/invariant.c"
+#include "gc/large-object.c"
 #include "gc/mark-compact.c"
+#include "gc/mark-region.c"
 #include "gc/model.c"
 #include "gc/new-object.c"
 #include "gc/object-size.c"
 #include "gc/object.c"
 #include "gc/objptr.c"
 #include "gc/pack.c"
+#include "gc/parallel-mark-compact.c"
+#include "gc/parallel.c"
+#include "gc/pause-histogram.c"
 #include "gc/pointer.c"
 #include "gc/profiling.c"
 #include "gc/rusage.c"
+#include "gc/safepoint.c"
 #include "gc/share.c"
 #include "gc/signals.c"
 #include "gc/size.c"
 #include "gc/sources.c"
 #include "gc/stack.c"
+#include "gc/stats-segment.c"
+#include "gc/survivor.c"
 #include "gc/switch-thread.c"
 #include "gc/thread.c"
 #include "gc/translate.c"
 #include "gc/weak.c"
+#include "gc/world-chunk.c"
+#include "gc/world-delta.c"
 #include "gc/world.c"
@@ -46,17 +46,30 @@ typedef GC_state GCState_t;
 #include "gc/sysvals.h"
 #include "gc/controls.h"
 #include "gc/major.h"
+#include "gc/pause-histogram.h"
 #include "gc/statistics.h"
+#include "gc/event-log.h"
+#include "gc/stats-segment.h"
 #include "gc/forward.h"
 #include "gc/cheney-copy.h"
+#include "gc/adaptive-nursery.h"
+#include "gc/parallel.h"
 #include "gc/hash-cons.h"
 #include "gc/dfs-mark.h"
 #include "gc/mark-compact.h"
+#include "gc/parallel-mark-compact.h"
+#include "gc/concurrent-mark.h"
+#include "gc/mark-region.h"
+#include "gc/large-object.h"
+#include "gc/heap-census.h"
+#include "gc/heap-dump.h"
+#include "gc/survivor.h"
 #include "gc/invariant.h"
 #include "gc/atomic.h"
 #include "gc/enter_leave.h"
 #include "gc/signals.h"
 #include "gc/handler.h"
+#include "gc/safepoint.h"
 #include "gc/switch-thread.h"
 #include "gc/garbage-collection.h"
 #include "gc/new-object.h"
@@ -64,10 +77,13 @@ typedef GC_state GCState_t;
 #include "gc/sources.h"
 #include "gc/call-stack.h"
 #include "gc/profiling.h"
+#include "gc/alloc-sample.h"
 #include "gc/rusage.h"
+#include "gc/world-chunk.h"
+#include "gc/world.h"
+#include "gc/world-delta.h"
 #include "gc/gc_state.h"
 #include "gc/init-world.h"
-#include "gc/world.h"
 #include "gc/init.h"
 #include "gc/done.h"
 #include "gc/copy-thread.h"
@@ -0,0 +1,89 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initAdaptiveNursery (GC_state s) {
+  s->adaptiveNursery.bytesAllocated = 0.0;
+  s->adaptiveNursery.bytesCopied = 0.0;
+  s->adaptiveNursery.bytesTimed = 0.0;
+  s->adaptiveNursery.pauseTime = 0.0;
+}
+
+bool useAdaptiveNursery (GC_state s) {
+  return s->controls.adaptiveNursery or s->controls.maxMinorPause > 0;
+}
+
+void sampleMinorGC (GC_state s, size_t bytesAllocated,
+                    size_t bytesCopied, uintmax_t pauseTime) {
+  struct GC_adaptiveNursery *an;
+
+  an = &s->adaptiveNursery;
+  an->bytesAllocated =
+    GC_ADAPTIVE_NURSERY_DECAY * an->bytesAllocated + (double)bytesAllocated;
+  an->bytesCopied =
+    GC_ADAPTIVE_NURSERY_DECAY * an->bytesCopied + (double)bytesCopied;
+  an->bytesTimed =
+    GC_ADAPTIVE_NURSERY_DECAY * an->bytesTimed + (double)bytesCopied;
+  an->pauseTime =
+    GC_ADAPTIVE_NURSERY_DECAY * an->pauseTime + (double)pauseTime;
+}
+
+void forgetNurserySurvival (GC_state s) {
+  s->adaptiveNursery.bytesAllocated = 0.0;
+  s->adaptiveNursery.bytesCopied = 0.0;
+}
+
+double getNurserySurvival (GC_state s) {
+  if (s->adaptiveNursery.bytesAllocated <= 0.0)
+    return 0.0;
+  return s->adaptiveNursery.bytesCopied / s->adaptiveNursery.bytesAllocated;
+}
+
+bool isMinorGCWorthwhile (GC_state s) {
+  double survival;
+
+  survival = getNurserySurvival (s);
+  if (survival <= GC_ADAPTIVE_NURSERY_MAX_SURVIVAL)
+    return TRUE;
+  if (DEBUG_GENERATIONAL or s->controls.messages)
+    fprintf (stderr,
+             "[GC:\tno minor GCs until the next major GC; survival rate %.1f%%.]\n",
+             100.0 * survival);
+  return FALSE;
+}
+
+/* sizeofNurseryAdaptive (s, nurserySize, nurseryBytesRequested)
+ *
+ * Returns the size of the nursery to use out of the nurserySize bytes
+ * available, which is smaller only if the survivors of a full nursery
+ * are predicted to take longer than max-minor-pause-ms to copy.
+ */
+size_t sizeofNurseryAdaptive (GC_state s, size_t nurserySize,
+                              size_t nurseryBytesRequested) {
+  struct GC_adaptiveNursery *an;
+  double predicted, survival, target, timePerByte;
+  size_t size;
+
+  an = &s->adaptiveNursery;
+  size = nurserySize;
+  survival = getNurserySurvival (s);
+  timePerByte = (an->bytesTimed > 0.0) ? an->pauseTime / an->bytesTimed : 0.0;
+  predicted = timePerByte * survival * (double)nurserySize;
+  target = 1000.0 * (double)s->controls.maxMinorPause;
+  if (s->controls.maxMinorPause > 0 and predicted > target) {
+    size = (size_t)(target / (timePerByte * survival));
+    size = max (size, GC_ADAPTIVE_NURSERY_MIN_SIZE);
+    size = max (size, nurseryBytesRequested + s->alignment);
+    size = min (size, nurserySize);
+    predicted = timePerByte * survival * (double)size;
+  }
+  if (DEBUG_GENERATIONAL or s->controls.messages)
+    fprintf (stderr,
+             "[GC:\tnursery of %s bytes for survival rate %.1f%%; predicted minor pause %.1f ms.]\n",
+             uintmaxToCommaString(size),
+             100.0 * survival,
+             predicted / 1000.0);
+  return size;
+}
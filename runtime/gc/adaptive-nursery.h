@@ -0,0 +1,47 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With adaptive-nursery, each minor GC records how many of the bytes
+ * allocated in the nursery survived, and how long it took to copy
+ * them.  Minor GCs are not used while more than
+ * GC_ADAPTIVE_NURSERY_MAX_SURVIVAL of the nursery survives, since
+ * they would copy most of it into the old generation anyway; the
+ * survival rate is forgotten at each major GC, so that minor GCs are
+ * tried again.  With max-minor-pause-ms, the nursery is shrunk to
+ * the size whose survivors are predicted to be copied in that time.
+ *
+ * The samples are kept as sums that decay by
+ * GC_ADAPTIVE_NURSERY_DECAY at each minor GC, so that the estimates
+ * follow the recent behavior of the program.
+ */
+#define GC_ADAPTIVE_NURSERY_DECAY 0.75
+#define GC_ADAPTIVE_NURSERY_MAX_SURVIVAL 0.5
+#define GC_ADAPTIVE_NURSERY_MIN_SIZE 0x40000
+
+struct GC_adaptiveNursery {
+  double bytesAllocated; /* Since the last major GC. */
+  double bytesCopied; /* Since the last major GC. */
+  double bytesTimed; /* Bytes copied by the minor GCs in pauseTime. */
+  double pauseTime; /* In microseconds. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initAdaptiveNursery (GC_state s);
+static inline bool useAdaptiveNursery (GC_state s);
+static void sampleMinorGC (GC_state s, size_t bytesAllocated,
+                           size_t bytesCopied, uintmax_t pauseTime);
+static inline void forgetNurserySurvival (GC_state s);
+static inline double getNurserySurvival (GC_state s);
+static bool isMinorGCWorthwhile (GC_state s);
+static size_t sizeofNurseryAdaptive (GC_state s, size_t nurserySize,
+                                     size_t nurseryBytesRequested);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
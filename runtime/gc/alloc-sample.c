@@ -0,0 +1,333 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initAllocSampler (GC_state s) {
+  struct GC_allocSampler *as;
+
+  as = &s->allocSampler;
+  as->bytes = 0;
+  as->bytesToSample = 0;
+  as->frames = NULL;
+  as->frontier = NULL;
+  as->numFrames = 0;
+  as->numStacks = 0;
+  as->random = ((uint64_t)time (NULL) << 20) ^ (uint64_t)getpid () ^ 0x9E3779B97F4A7C15ULL;
+  as->samples = 0;
+  as->stacks = NULL;
+  as->stacksSize = 0;
+  if (not useAllocSampler (s))
+    return;
+  as->frames =
+    (uint32_t*)(malloc_safe (GC_ALLOC_SAMPLE_MAX_FRAMES * sizeof(uint32_t)));
+  as->bytesToSample = nextAllocSampleInterval (s);
+}
+
+bool useAllocSampler (GC_state s) {
+  return s->controls.allocSampleBytes > 0;
+}
+
+/* nextAllocSampleInterval (s)
+ *
+ * returns the number of bytes to allocate before the next sample,
+ * drawn from an exponential distribution whose mean is
+ * alloc-sample-bytes.
+ */
+size_t nextAllocSampleInterval (GC_state s) {
+  struct GC_allocSampler *as;
+  double interval;
+  double u;
+
+  as = &s->allocSampler;
+  /* xorshift64* */
+  as->random ^= as->random >> 12;
+  as->random ^= as->random << 25;
+  as->random ^= as->random >> 27;
+  u = (double)((as->random * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+  interval = -log (1.0 - u) * (double)s->controls.allocSampleBytes;
+  interval = min (interval, 32.0 * (double)s->controls.allocSampleBytes);
+  return (interval < 1.0) ? 1 : (size_t)interval;
+}
+
+void allocSampleFrame (GC_state s, GC_frameIndex i) {
+  struct GC_allocSampler *as;
+
+  as = &s->allocSampler;
+  if (as->numFrames < GC_ALLOC_SAMPLE_MAX_FRAMES)
+    as->frames[as->numFrames++] = i;
+}
+
+uint64_t hashAllocSampleStack (const uint32_t *frames, uint32_t numFrames) {
+  uint64_t h;
+
+  h = 0xCBF29CE484222325ULL ^ numFrames;
+  for (uint32_t i = 0; i < numFrames; i++)
+    h = (h ^ frames[i]) * 0x9E3779B97F4A7C15ULL;
+  return h ^ (h >> 29);
+}
+
+void growAllocSampleStacks (GC_state s) {
+  struct GC_allocSampler *as;
+  struct GC_allocSampleStack *old;
+  size_t oldSize;
+
+  as = &s->allocSampler;
+  old = as->stacks;
+  oldSize = as->stacksSize;
+  as->stacksSize = (0 == oldSize) ? 0x400 : 2 * oldSize;
+  as->stacks =
+    (struct GC_allocSampleStack *)
+    (calloc_safe (as->stacksSize, sizeof(struct GC_allocSampleStack)));
+  for (size_t i = 0; i < oldSize; i++) {
+    struct GC_allocSampleStack *st;
+
+    if (0 == old[i].numFrames)
+      continue;
+    for (size_t j = old[i].hash; ; j++) {
+      st = &as->stacks[j & (as->stacksSize - 1)];
+      if (0 == st->numFrames)
+        break;
+    }
+    *st = old[i];
+  }
+  free (old);
+}
+
+/* findAllocSampleStack (s, hash)
+ *
+ * returns the entry of the stack being sampled, which has hash, or
+ * the empty entry where it belongs.
+ */
+struct GC_allocSampleStack *findAllocSampleStack (GC_state s, uint64_t hash) {
+  struct GC_allocSampler *as;
+
+  as = &s->allocSampler;
+  for (size_t j = hash; ; j++) {
+    struct GC_allocSampleStack *st;
+
+    st = &as->stacks[j & (as->stacksSize - 1)];
+    if (0 == st->numFrames
+        or (hash == st->hash
+            and as->numFrames == st->numFrames
+            and 0 == memcmp (as->frames, st->frames,
+                             as->numFrames * sizeof(uint32_t))))
+      return st;
+  }
+}
+
+/* sampleAllocStack (s, bytes)
+ *
+ * attributes bytes to the current stack.
+ */
+void sampleAllocStack (GC_state s, size_t bytes) {
+  struct GC_allocSampler *as;
+  struct GC_allocSampleStack *st;
+  uint64_t hash;
+
+  as = &s->allocSampler;
+  as->numFrames = 0;
+  foreachStackFrame (s, allocSampleFrame);
+  if (0 == as->numFrames)
+    return;
+  if (4 * (as->numStacks + 1) > 3 * as->stacksSize)
+    growAllocSampleStacks (s);
+  hash = hashAllocSampleStack (as->frames, as->numFrames);
+  st = findAllocSampleStack (s, hash);
+  if (0 == st->numFrames) {
+    st->bytes = 0;
+    st->frames = (uint32_t*)(malloc_safe (as->numFrames * sizeof(uint32_t)));
+    memcpy (st->frames, as->frames, as->numFrames * sizeof(uint32_t));
+    st->hash = hash;
+    st->numFrames = as->numFrames;
+    st->samples = 0;
+    as->numStacks++;
+  }
+  st->bytes += bytes;
+  st->samples++;
+  as->samples++;
+  if (DEBUG_PROFILE)
+    fprintf (stderr, "sampleAllocStack (%s) with %"PRIu32" frames\n",
+             uintmaxToCommaString (bytes), as->numFrames);
+}
+
+/* Count bytes towards the next sample, without taking it. */
+void chargeAllocSampleBytes (GC_state s, size_t bytes) {
+  struct GC_allocSampler *as;
+
+  as = &s->allocSampler;
+  as->bytes += bytes;
+  as->bytesToSample -= min (bytes, as->bytesToSample);
+}
+
+/* Take the sample that is due, if any.  It walks the stack, so it may
+ * only be taken where s->stackTop is up to date.
+ */
+void takeAllocSample (GC_state s) {
+  struct GC_allocSampler *as;
+
+  unless (useAllocSampler (s))
+    return;
+  as = &s->allocSampler;
+  if (as->bytesToSample > 0)
+    return;
+  sampleAllocStack (s, as->bytes);
+  as->bytes = 0;
+  as->bytesToSample = nextAllocSampleInterval (s);
+}
+
+void addAllocSampleBytes (GC_state s, size_t bytes) {
+  chargeAllocSampleBytes (s, bytes);
+  takeAllocSample (s);
+}
+
+/* Count the bytes allocated in the nursery since the frontier was last
+ * counted.  A frontier that is not after that one is in a nursery that
+ * a GC has since replaced.  The sample that they make due is left to
+ * the next entry to the runtime, which the limit set by
+ * setAllocSampleLimit, now below the frontier, brings about.
+ */
+void countAllocSampleBytes (GC_state s) {
+  struct GC_allocSampler *as;
+
+  unless (useAllocSampler (s))
+    return;
+  as = &s->allocSampler;
+  if (s->heap.nursery <= as->frontier and as->frontier < s->frontier)
+    chargeAllocSampleBytes (s, (size_t)(s->frontier - as->frontier));
+  as->frontier = s->frontier;
+}
+
+/* Lower the limit on leaving the runtime, so that the mutator traps
+ * when the next sample is due, as setIncrementalMarkLimit does.
+ */
+void setAllocSampleLimit (GC_state s) {
+  struct GC_allocSampler *as;
+  pointer limit;
+
+  unless (useAllocSampler (s))
+    return;
+  as = &s->allocSampler;
+  as->frontier = s->frontier;
+  unless (1 == s->atomicState)
+    return;
+  if (as->bytesToSample < (size_t)(s->limit - s->frontier)) {
+    limit = s->frontier + as->bytesToSample;
+    if (limit < s->limit)
+      s->limit = limit;
+  }
+}
+
+/* writeAllocSampleStacks (s, fileName)
+ *
+ * writes the samples as collapsed stacks, one line for each stack,
+ * from its bottom frame to its top, followed by the bytes sampled in
+ * it.  A frame is written as the source functions of its
+ * sequence, or, without them, as its frame index.
+ */
+void writeAllocSampleStacks (GC_state s, const char *fileName) {
+  struct GC_allocSampler *as;
+  FILE *f;
+
+  as = &s->allocSampler;
+  f = fopen_safe (fileName, "wb");
+  for (size_t k = 0; k < as->stacksSize; k++) {
+    struct GC_allocSampleStack *st;
+    bool first;
+
+    st = &as->stacks[k];
+    if (0 == st->numFrames)
+      continue;
+    first = TRUE;
+    for (uint32_t j = st->numFrames; j > 0; j--) {
+      GC_frameIndex i;
+
+      i = st->frames[j - 1];
+      unless (i < s->sourceMaps.frameSourcesLength
+              and writeCollapsedSourceSeq (s, f, s->sourceMaps.frameSources[i],
+                                           &first)) {
+        char name[32];
+
+        snprintf (name, sizeof(name), "<frame "FMTFI">", i);
+        writeCollapsedName (f, name, &first);
+      }
+    }
+    writeChar (f, ' ');
+    writeUintmaxU (f, st->bytes);
+    writeNewline (f);
+  }
+  fclose_safe (f);
+}
+
+/* writeAllocSamples (s, fileName)
+ *
+ * writes the samples as an mlmon.out file of allocation profiling
+ * with stack information, which mlprof reads, or, with profile-format
+ * collapsed, as collapsed stacks.  In an mlmon.out file, the samples
+ * of a stack are attributed to the source function of its top frame,
+ * and, once, to each function on it.
+ */
+void writeAllocSamples (GC_state s, const char *fileName) {
+  struct GC_allocSampler *as;
+  struct GC_profileData p;
+  uint32_t profileMasterLength;
+  size_t *seen;
+
+  if (GC_PROFILE_FORMAT_COLLAPSED == s->controls.profileFormat) {
+    writeAllocSampleStacks (s, fileName);
+    return;
+  }
+  as = &s->allocSampler;
+  profileMasterLength = s->sourceMaps.sourcesLength + s->sourceMaps.sourceNamesLength;
+  p.countSeq = NULL;
+  p.countTop = (uintmax_t*)(calloc_safe (max (profileMasterLength, 1u),
+                                         sizeof(uintmax_t)));
+  p.stack = (struct GC_profileStack *)(calloc_safe (max (profileMasterLength, 1u),
+                                                    sizeof(struct GC_profileStack)));
+  p.total = 0;
+  p.totalGC = 0;
+  seen = (size_t*)(calloc_safe (max (profileMasterLength, 1u), sizeof(size_t)));
+  for (size_t k = 0; k < as->stacksSize; k++) {
+    struct GC_allocSampleStack *st;
+
+    st = &as->stacks[k];
+    if (0 == st->numFrames)
+      continue;
+    p.total += st->bytes;
+    if (0 == s->sourceMaps.sourcesLength)
+      continue;
+    for (uint32_t j = 0; j < st->numFrames; j++) {
+      GC_sourceSeqIndex sourceSeqIndex;
+      uint32_t *sourceSeq;
+
+      sourceSeqIndex =
+        (st->frames[j] < s->sourceMaps.frameSourcesLength)
+        ? s->sourceMaps.frameSources[st->frames[j]]
+        : SOURCE_SEQ_UNKNOWN;
+      sourceSeq = s->sourceMaps.sourceSeqs[sourceSeqIndex];
+      if (0 == j) {
+        GC_sourceIndex top;
+
+        top = (sourceSeq[0] > 0) ? sourceSeq[sourceSeq[0]] : SOURCES_INDEX_UNKNOWN;
+        p.countTop[top] += st->bytes;
+        p.countTop[sourceIndexToProfileMasterIndex (s, top)] += st->bytes;
+      }
+      for (uint32_t i = 1; i <= sourceSeq[0]; i++) {
+        GC_profileMasterIndex pmi[2];
+
+        pmi[0] = (GC_profileMasterIndex)sourceSeq[i];
+        pmi[1] = sourceIndexToProfileMasterIndex (s, sourceSeq[i]);
+        for (int l = 0; l < 2; l++)
+          unless (k + 1 == seen[pmi[l]]) {
+            seen[pmi[l]] = k + 1;
+            p.stack[pmi[l]].ticks += st->bytes;
+          }
+      }
+    }
+  }
+  writeProfile (s, fileName, &p, "alloc\n", TRUE);
+  free (seen);
+  free (p.countTop);
+  free (p.stack);
+}
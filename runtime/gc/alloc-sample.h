@@ -0,0 +1,73 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With alloc-sample-bytes, the call stack is sampled once in about
+ * every that many bytes allocated.  The intervals between samples are
+ * drawn from an exponential distribution, so that the samples are not
+ * in step with a loop of the program, and each sample is weighted by
+ * the bytes allocated since the one before.
+ *
+ * The mutator is stopped for a sample as it is for a slice of an
+ * incremental mark: leaving the runtime lowers the limit to the
+ * frontier at which the next sample is due; entering the runtime
+ * counts the bytes that the mutator has allocated since it left; see
+ * countAllocSampleBytes.  Objects that the runtime allocates in the
+ * nursery, such as IntInf results, are counted the same way when it
+ * moves the frontier, but their sample is only taken on entering the
+ * runtime, since the stack top is not up to date in the C calls that
+ * allocate them.  Objects allocated outside of the nursery are counted
+ * and sampled as they are allocated.
+ *
+ * Each distinct stack, of at most GC_ALLOC_SAMPLE_MAX_FRAMES frames
+ * from the top, is kept once, with its samples, in an open-addressed
+ * hash table.
+ */
+#define GC_ALLOC_SAMPLE_MAX_FRAMES 256
+
+struct GC_allocSampleStack {
+  uintmax_t bytes; /* Of the samples of the stack. */
+  uint32_t *frames; /* Frame indices, from the top of the stack. */
+  uint64_t hash;
+  uint32_t numFrames; /* 0 if the entry is empty. */
+  uintmax_t samples;
+};
+
+struct GC_allocSampler {
+  size_t bytes; /* Allocated since the last sample. */
+  size_t bytesToSample; /* Until the next sample. */
+  uint32_t *frames; /* Of the stack being sampled. */
+  pointer frontier; /* When the mutator last left the runtime. */
+  size_t numStacks;
+  uint32_t numFrames;
+  uint64_t random;
+  uintmax_t samples;
+  struct GC_allocSampleStack *stacks;
+  size_t stacksSize; /* A power of two. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initAllocSampler (GC_state s);
+static inline bool useAllocSampler (GC_state s);
+static size_t nextAllocSampleInterval (GC_state s);
+static void allocSampleFrame (GC_state s, GC_frameIndex i);
+static uint64_t hashAllocSampleStack (const uint32_t *frames, uint32_t numFrames);
+static void growAllocSampleStacks (GC_state s);
+static struct GC_allocSampleStack *findAllocSampleStack (GC_state s, uint64_t hash);
+static void sampleAllocStack (GC_state s, size_t bytes);
+static inline void chargeAllocSampleBytes (GC_state s, size_t bytes);
+static void takeAllocSample (GC_state s);
+static void addAllocSampleBytes (GC_state s, size_t bytes);
+static void countAllocSampleBytes (GC_state s);
+static void setAllocSampleLimit (GC_state s);
+static void writeAllocSampleStacks (GC_state s, const char *fileName);
+static void writeAllocSamples (GC_state s, const char *fileName);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -53,15 +53,29 @@ pointer GC_arrayAllocate (GC_state s,
              uintmaxToCommaString(arraySize),
              uintmaxToCommaString(arraySizeAligned),
              uintmaxToCommaString(ensureBytesFree));
-  if (arraySizeAligned >= s->controls.oldGenArraySize) {
+  if (0 == numObjptrs
+      and 0 < s->controls.largeObjectSize
+      and arraySizeAligned >= s->controls.largeObjectSize
+      and NULL != (frontier = allocLargeObject (s, arraySizeAligned, ensureBytesFree))) {
+    s->cumulativeStatistics.bytesAllocated += arraySizeAligned;
+    if (useAllocSampler (s))
+      addAllocSampleBytes (s, arraySizeAligned);
+  } else if (arraySizeAligned >= s->controls.oldGenArraySize) {
     if (not hasHeapBytesFree (s, arraySizeAligned, ensureBytesFree)) {
       enter (s);
       performGC (s, arraySizeAligned, ensureBytesFree, FALSE, TRUE);
       leave (s);
+    } else if (isIncrementalMarkPending (s)) {
+      /* Allocation in the old generation also paces the mark. */
+      enter (s);
+      performMarkSlice (s);
+      leave (s);
     }
     frontier = s->heap.start + s->heap.oldGenSize;
     s->heap.oldGenSize += arraySizeAligned;
     s->cumulativeStatistics.bytesAllocated += arraySizeAligned;
+    if (useAllocSampler (s))
+      addAllocSampleBytes (s, arraySizeAligned);
   } else {
     size_t bytesRequested;
     pointer newFrontier;
@@ -76,6 +90,7 @@ pointer GC_arrayAllocate (GC_state s,
     newFrontier = frontier + arraySizeAligned;
     assert (isFrontierAligned (s, newFrontier));
     s->frontier = newFrontier;
+    countAllocSampleBytes (s);
   }
   last = frontier + arraySize;
   *((GC_arrayCounter*)(frontier)) = 0;
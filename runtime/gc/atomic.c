@@ -8,13 +8,17 @@
 
 void beginAtomic (GC_state s) {
   s->atomicState++;
-  if (0 == s->limit)
+  /* The limit may be zero for a signal or lowered for an incremental
+   * mark; see setIncrementalMarkLimit.
+   */
+  if (s->limit < s->limitPlusSlop - GC_HEAP_LIMIT_SLOP)
     s->limit = s->limitPlusSlop - GC_HEAP_LIMIT_SLOP;
 }
 
 void endAtomic (GC_state s) {
   s->atomicState--;
   if (0 == s->atomicState 
-      and s->signalsInfo.signalIsPending)
+      and (s->signalsInfo.signalIsPending
+           or isSafepointRequested (s)))
     s->limit = 0;
 }
@@ -21,7 +21,10 @@ void updateWeaksForCheneyCopy (GC_state s) {
     if (DEBUG_WEAK)
       fprintf (stderr, "updateWeaksForCheneyCopy  w = "FMTPTR"  ", (uintptr_t)w);
     p = objptrToPointer (w->objptr, s->heap.start);
-    if (GC_FORWARDED == getHeader (p)) {
+    if (isPointerInLargeObjectSpace (s, p) and isLargeObjectMarked (s, p)) {
+      if (DEBUG_WEAK)
+        fprintf (stderr, "large object marked\n");
+    } else if (GC_FORWARDED == getHeader (p)) {
       if (DEBUG_WEAK)
         fprintf (stderr, "forwarded from "FMTOBJPTR" to "FMTOBJPTR"\n",
                  w->objptr,
@@ -46,6 +49,78 @@ void swapHeapsForCheneyCopy (GC_state s) {
   setCardMapAndCrossMap (s);
 }
 
+/* Buffers waste at most 1/GC_PARALLEL_LARGE_RATIO of each buffer, and
+ * each worker may leave one buffer partially used.  Only copy in
+ * parallel if the to-space can absorb that waste even if everything
+ * in the old generation is live.
+ */
+bool useParallelCheneyCopy (GC_state s, pointer toStart) {
+  size_t available, needed;
+
+  unless (useParallelGC (s))
+    return FALSE;
+  available = s->secondaryHeap.size - (size_t)(toStart - s->secondaryHeap.start);
+  needed = s->heap.oldGenSize
+           + s->heap.oldGenSize / (GC_PARALLEL_LARGE_RATIO / 2)
+           + (s->parallelState.numThreads + 1) * GC_PARALLEL_BUFFER_SIZE;
+  return needed <= available;
+}
+
+void majorParallelCheneyCopyJob (GC_state s) {
+  struct GC_worker *w;
+
+  w = s->worker;
+  if (0 == w->id)
+    foreachGlobalObjptr (s, forwardObjptrParallel);
+  drainWorkParallel (s, forwardObjptrParallel);
+  fillWorkerBuffer (s, w);
+}
+
+/* Copy with s->parallelState.numThreads GC threads.  Each thread
+ * copies into to-space buffers of its own, taken from the shared
+ * to-space, and fills what is left of the buffers when it is done.
+ */
+pointer majorParallelCheneyCopy (GC_state s, pointer toStart) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  ps->currentStack = getStackCurrent (s);
+  ps->numActive = ps->numThreads;
+  ps->toBack = (uintptr_t)toStart;
+  ps->toLimit = s->forwardState.toLimit;
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    w->back = NULL;
+    w->bytesCopied = 0;
+    w->bytesFilled = 0;
+    w->limit = NULL;
+    w->numFills = 0;
+    w->scan = NULL;
+    w->weaks = NULL;
+  }
+  runParallel (s, majorParallelCheneyCopyJob);
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    assert (isWorkDequeEmpty (&w->deque));
+    s->cumulativeStatistics.bytesCopiedByThread[i] += w->bytesCopied;
+    countFillersForHeapCensus (s, w->bytesFilled, w->numFills);
+    if (DEBUG_PARALLEL or s->controls.messages)
+      fprintf (stderr,
+               "[GC:\tGC thread %"PRIu32" copied %s bytes.]\n",
+               i, uintmaxToCommaString(w->bytesCopied));
+    while (w->weaks != NULL) {
+      GC_weak weak = w->weaks;
+
+      w->weaks = weak->link;
+      weak->link = s->weaks;
+      s->weaks = weak;
+    }
+  }
+  return (pointer)(ps->toBack);
+}
+
 void majorCheneyCopyGC (GC_state s) {
   size_t bytesCopied;
   struct rusage ru_start;
@@ -56,6 +131,7 @@ void majorCheneyCopyGC (GC_state s) {
     startTiming (&ru_start);
   s->cumulativeStatistics.numCopyingGCs++;
   s->forwardState.amInMinorGC = FALSE;
+  startLargeObjectMark (s);
   if (DEBUG or s->controls.messages) {
     fprintf (stderr, 
              "[GC: Starting major Cheney-copy;]\n");
@@ -78,9 +154,13 @@ void majorCheneyCopyGC (GC_state s) {
    */
   assert (s->secondaryHeap.size >= s->heap.oldGenSize);
   toStart = alignFrontier (s, s->secondaryHeap.start);
-  s->forwardState.back = toStart;
-  foreachGlobalObjptr (s, forwardObjptr);
-  foreachObjptrInRange (s, toStart, &s->forwardState.back, forwardObjptr, TRUE);
+  if (useParallelCheneyCopy (s, toStart)) {
+    s->forwardState.back = majorParallelCheneyCopy (s, toStart);
+  } else {
+    s->forwardState.back = toStart;
+    foreachGlobalObjptr (s, forwardObjptr);
+    foreachObjptrInRange (s, toStart, &s->forwardState.back, forwardObjptr, TRUE);
+  }
   updateWeaksForCheneyCopy (s);
   s->secondaryHeap.oldGenSize = (size_t)(s->forwardState.back - s->secondaryHeap.start);
   bytesCopied = s->secondaryHeap.oldGenSize;
@@ -99,9 +179,128 @@ void majorCheneyCopyGC (GC_state s) {
 /*                 Minor Cheney Copying Collection                  */
 /* ---------------------------------------------------------------- */
 
+/* As for useParallelCheneyCopy, the space between the old generation
+ * and the nursery must absorb the waste of the promotion buffers.
+ */
+bool useParallelMinorCheneyCopy (GC_state s, size_t bytesAllocated) {
+  size_t available, needed;
+
+  unless (useParallelGC (s))
+    return FALSE;
+  available = (size_t)(s->heap.nursery - s->forwardState.toStart);
+  needed = bytesAllocated
+           + bytesAllocated / (GC_PARALLEL_LARGE_RATIO / 2)
+           + (s->parallelState.numThreads + 1) * GC_PARALLEL_BUFFER_SIZE;
+  return needed <= available;
+}
+
+void minorParallelCheneyCopyJob (GC_state s) {
+  struct GC_worker *w;
+  struct GC_parallelState *ps;
+  pointer oldGenEnd, stripeEnd;
+  size_t stripe;
+
+  w = s->worker;
+  ps = w->parallel;
+  if (0 == w->id)
+    foreachGlobalObjptr (s, forwardObjptrIfInNurseryParallel);
+  oldGenEnd = s->heap.start + s->heap.oldGenSize;
+  while (claimRegion (ps, &stripe)) {
+    stripeEnd = s->heap.start
+                + cardMapIndexToSize ((stripe + 1) * GC_PARALLEL_STRIPE_CARDS);
+    if (oldGenEnd < stripeEnd)
+      stripeEnd = oldGenEnd;
+    forwardInterGenerationalObjptrsInStripe (s, ps->stripeStarts[stripe], stripeEnd);
+  }
+  drainWorkParallel (s, forwardObjptrIfInNurseryParallel);
+  fillWorkerBuffer (s, w);
+}
+
+/* Copy the nursery with s->parallelState.numThreads GC threads.  The
+ * card map is divided into stripes of GC_PARALLEL_STRIPE_CARDS cards,
+ * and each thread promotes the objects it finds into buffers of its
+ * own at the end of the old generation.
+ */
+pointer minorParallelCheneyCopy (GC_state s) {
+  struct GC_parallelState *ps;
+  pointer oldGenEnd, objectStart;
+
+  ps = &s->parallelState;
+  updateCrossMap (s);
+  ps->numRegions =
+    align (sizeToCardMapIndex (align (s->heap.oldGenSize, CARD_SIZE)),
+           GC_PARALLEL_STRIPE_CARDS)
+    / GC_PARALLEL_STRIPE_CARDS;
+  if (ps->stripeStartsLength < ps->numRegions) {
+    free (ps->stripeStarts);
+    ps->stripeStartsLength = ps->numRegions;
+    ps->stripeStarts =
+      (pointer*)(calloc_safe (ps->stripeStartsLength, sizeof (pointer)));
+  }
+  ps->nextRegion = 0;
+  runParallel (s, findStripeStartsJob);
+  /* Turn the last boundary in each stripe into the first object owned
+   * by the next stripe.
+   */
+  oldGenEnd = s->heap.start + s->heap.oldGenSize;
+  objectStart = alignFrontier (s, s->heap.start);
+  for (size_t stripe = 0; stripe < ps->numRegions; stripe++) {
+    pointer last;
+
+    last = ps->stripeStarts[stripe];
+    ps->stripeStarts[stripe] = objectStart;
+    if (NULL == last)
+      continue;
+    if (last < oldGenEnd)
+      objectStart = last + sizeofObject (s, advanceToObjectData (s, last));
+    else
+      objectStart = oldGenEnd;
+  }
+  ps->currentStack = getStackCurrent (s);
+  ps->nextRegion = 0;
+  ps->numActive = ps->numThreads;
+  ps->toBack = (uintptr_t)(s->forwardState.toStart);
+  ps->toLimit = s->heap.nursery;
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    w->back = NULL;
+    w->bytesCopied = 0;
+    w->bytesFilled = 0;
+    w->bytesScanned = 0;
+    w->limit = NULL;
+    w->numCardsMarked = 0;
+    w->numFills = 0;
+    w->scan = NULL;
+    w->weaks = NULL;
+  }
+  runParallel (s, minorParallelCheneyCopyJob);
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    assert (isWorkDequeEmpty (&w->deque));
+    s->cumulativeStatistics.bytesScannedMinor += w->bytesScanned;
+    s->cumulativeStatistics.numCardsMarked += w->numCardsMarked;
+    if (DEBUG_PARALLEL or s->controls.messages)
+      fprintf (stderr,
+               "[GC:\tGC thread %"PRIu32" scanned %s bytes and copied %s bytes.]\n",
+               i, uintmaxToCommaString(w->bytesScanned),
+               uintmaxToCommaString(w->bytesCopied));
+    while (w->weaks != NULL) {
+      GC_weak weak = w->weaks;
+
+      w->weaks = weak->link;
+      weak->link = s->weaks;
+      s->weaks = weak;
+    }
+  }
+  return (pointer)(ps->toBack);
+}
+
 void minorCheneyCopyGC (GC_state s) {
   size_t bytesAllocated;
-  size_t bytesCopied;
+  size_t bytesCopied, bytesCopiedToHoles, bytesCopiedToSurvivors;
+  uintmax_t pauseStart;
   struct rusage ru_start;
 
   if (DEBUG_GENERATIONAL)
@@ -117,6 +316,7 @@ void minorCheneyCopyGC (GC_state s) {
   } else {
     if (detailedGCTime (s))
       startTiming (&ru_start);
+    pauseStart = useAdaptiveNursery (s) ? GC_getMonotonicTime () : 0;
     s->cumulativeStatistics.numMinorGCs++;
     s->forwardState.amInMinorGC = TRUE;
     if (DEBUG_GENERATIONAL or s->controls.messages) {
@@ -132,23 +332,41 @@ void minorCheneyCopyGC (GC_state s) {
     s->forwardState.toLimit = s->forwardState.toStart + bytesAllocated;
     assert (invariantForGC (s));
     s->forwardState.back = s->forwardState.toStart;
-    /* Forward all globals.  Would like to avoid doing this once all
-     * the globals have been assigned.
-     */
-    foreachGlobalObjptr (s, forwardObjptrIfInNursery);
-    forwardInterGenerationalObjptrs (s);
-    foreachObjptrInRange (s, s->forwardState.toStart, &s->forwardState.back, 
-                          forwardObjptrIfInNursery, TRUE);
+    bytesCopiedToHoles = 0;
+    bytesCopiedToSurvivors = 0;
+    if (s->survivorSpaces.size > 0) {
+      s->forwardState.toLimit = s->heap.nursery;
+      bytesCopiedToSurvivors = minorCheneyCopyToSurvivors (s, FALSE);
+    } else if (useHolesForMinor (s)) {
+      bytesCopiedToHoles = minorCheneyCopyToHoles (s);
+    } else if (useParallelMinorCheneyCopy (s, bytesAllocated)) {
+      s->forwardState.toLimit = s->heap.nursery;
+      s->forwardState.back = minorParallelCheneyCopy (s);
+    } else {
+      /* Forward all globals.  Would like to avoid doing this once all
+       * the globals have been assigned.
+       */
+      foreachGlobalObjptr (s, forwardObjptrIfInNursery);
+      forwardInterGenerationalObjptrs (s, forwardObjptrIfInNursery);
+      foreachObjptrInRange (s, s->forwardState.toStart, &s->forwardState.back, 
+                            forwardObjptrIfInNursery, TRUE);
+    }
     updateWeaksForCheneyCopy (s);
     bytesCopied = (size_t)(s->forwardState.back - s->forwardState.toStart);
-    s->cumulativeStatistics.bytesCopiedMinor += bytesCopied;
+    s->cumulativeStatistics.bytesCopiedMinor +=
+      bytesCopied + bytesCopiedToHoles + bytesCopiedToSurvivors;
     s->heap.oldGenSize += bytesCopied;
     s->lastMajorStatistics.numMinorGCs++;
+    if (useAdaptiveNursery (s))
+      sampleMinorGC (s, bytesAllocated,
+                     bytesCopied + bytesCopiedToHoles + bytesCopiedToSurvivors,
+                     GC_getMonotonicTime () - pauseStart);
     if (detailedGCTime (s))
       stopTiming (&ru_start, &s->cumulativeStatistics.ru_gcMinor);
     if (DEBUG_GENERATIONAL or s->controls.messages)
       fprintf (stderr, 
                "[GC: Finished minor Cheney-copy; copied %s bytes.]\n",
-               uintmaxToCommaString(bytesCopied));
+               uintmaxToCommaString(bytesCopied + bytesCopiedToHoles
+                                    + bytesCopiedToSurvivors));
   }
 }
@@ -10,7 +10,13 @@
 
 static inline void updateWeaksForCheneyCopy (GC_state s);
 static inline void swapHeapsForCheneyCopy (GC_state s);
+static inline bool useParallelCheneyCopy (GC_state s, pointer toStart);
+static void majorParallelCheneyCopyJob (GC_state s);
+static pointer majorParallelCheneyCopy (GC_state s, pointer toStart);
 static void majorCheneyCopyGC (GC_state s);
+static inline bool useParallelMinorCheneyCopy (GC_state s, size_t bytesAllocated);
+static void minorParallelCheneyCopyJob (GC_state s);
+static pointer minorParallelCheneyCopy (GC_state s);
 static void minorCheneyCopyGC (GC_state s);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,565 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                       Background Thread                          */
+/* ---------------------------------------------------------------- */
+
+void initConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  memset (cm, 0, sizeof (struct GC_concurrentMark));
+  /* The card map is the write barrier. */
+  unless (s->mutatorMarksCards)
+    s->controls.concurrentMark = FALSE;
+  cm->incremental = s->mutatorMarksCards
+                    and not s->controls.concurrentMark
+                    and s->controls.maxPause > 0;
+  unless (useConcurrentMark (s))
+    return;
+  cm->state = (GC_state)(calloc_safe (1, sizeof (struct GC_state)));
+  cm->slices = GC_INCREMENTAL_MARK_MIN_SLICES;
+  cm->trigger = GC_CONCURRENT_MARK_TRIGGER_MAX;
+  cm->worker.id = s->controls.gcThreads;
+  cm->worker.parallel = &s->parallelState;
+  cm->worker.state = cm->state;
+}
+
+bool useConcurrentMark (GC_state s) {
+  return s->controls.concurrentMark or s->concurrentMark.incremental;
+}
+
+bool isConcurrentMarkActive (GC_state s) {
+  return s->concurrentMark.active;
+}
+
+/* Returns TRUE if the background thread or the slices have finished
+ * marking, so that a GC can finish the mark without waiting.
+ */
+bool isConcurrentMarkDone (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  return cm->active
+         and not cm->remarked
+         and not __atomic_load_n (&cm->marking, __ATOMIC_ACQUIRE);
+}
+
+void *concurrentMarker (void *arg) {
+  struct GC_concurrentMark *cm;
+
+  cm = &((GC_state)arg)->concurrentMark;
+  pthread_mutex_lock (&cm->lock);
+  while (TRUE) {
+    while (not cm->marking)
+      pthread_cond_wait (&cm->wake, &cm->lock);
+    pthread_mutex_unlock (&cm->lock);
+    drainMarkStackConcurrent (cm);
+    pthread_mutex_lock (&cm->lock);
+    __atomic_store_n (&cm->marking, FALSE, __ATOMIC_RELEASE);
+    pthread_cond_signal (&cm->done);
+    /* Have the mutator finish the cycle without waiting for the
+     * nursery to fill.
+     */
+    unless (__atomic_load_n (&cm->cancel, __ATOMIC_RELAXED))
+      requestSafepoint ((GC_state)arg, GC_SAFEPOINT_REMARK);
+  }
+  return NULL;
+}
+
+/* Start the background thread with all asynchronous signals blocked,
+ * as for the GC threads; see startParallelHelpers.
+ */
+void startConcurrentMarker (GC_state s) {
+  struct GC_concurrentMark *cm;
+  sigset_t all, old;
+  int res;
+
+  cm = &s->concurrentMark;
+  if (pthread_mutex_init (&cm->lock, NULL)
+      or pthread_cond_init (&cm->wake, NULL)
+      or pthread_cond_init (&cm->done, NULL))
+    die ("Unable to initialize concurrent mark synchronization.");
+  sigfillset (&all);
+  sigdelset (&all, SIGBUS);
+  sigdelset (&all, SIGFPE);
+  sigdelset (&all, SIGILL);
+  sigdelset (&all, SIGSEGV);
+  pthread_sigmask (SIG_BLOCK, &all, &old);
+  res = pthread_create (&cm->thread, NULL, concurrentMarker, s);
+  pthread_sigmask (SIG_SETMASK, &old, NULL);
+  unless (0 == res) {
+    errno = res;
+    diee ("Unable to start concurrent mark thread.");
+  }
+  cm->pid = getpid ();
+  cm->started = TRUE;
+  if (DEBUG_CONCURRENT_MARK or s->controls.messages)
+    fprintf (stderr, "[GC: Started concurrent mark thread.]\n");
+}
+
+void deferStackForConcurrentMark (struct GC_concurrentMark *cm, pointer p) {
+  if (cm->stacksSize == cm->stacksCapacity) {
+    pointer *stacks;
+    size_t capacity;
+
+    capacity = (0 == cm->stacksCapacity) ? 64 : 2 * cm->stacksCapacity;
+    stacks = (pointer*)(calloc_safe (capacity, sizeof (pointer)));
+    if (cm->stacksSize > 0)
+      memcpy (stacks, cm->stacks, cm->stacksSize * sizeof (pointer));
+    free (cm->stacks);
+    cm->stacks = stacks;
+    cm->stacksCapacity = capacity;
+  }
+  cm->stacks[cm->stacksSize++] = p;
+}
+
+/* Like drainMarkStackParallel, but on the background thread, which
+ * has no one to share with.  A stack may be changing under the
+ * mutator, so it is left for the remark.
+ */
+void drainMarkStackConcurrent (struct GC_concurrentMark *cm) {
+  struct GC_worker *w;
+  GC_state s;
+
+  s = cm->state;
+  w = s->worker;
+  while (w->markStackSize > 0) {
+    GC_objectTypeTag tag;
+    pointer p;
+
+    if (__atomic_load_n (&cm->cancel, __ATOMIC_RELAXED)) {
+      w->markStackSize = 0;
+      return;
+    }
+    p = w->markStack[--w->markStackSize];
+    splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+    if (STACK_TAG == tag)
+      deferStackForConcurrentMark (cm, p);
+    else
+      scanObjectForParallelMark (s, p);
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/*                            Cycles                                */
+/* ---------------------------------------------------------------- */
+
+/* Start the next cycle once the old generation has filled the
+ * fraction trigger of the space that is free now.
+ */
+void setConcurrentMarkTrigger (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  cm->triggerSize =
+    s->heap.oldGenSize
+    + (size_t)(cm->trigger * (float)(s->heap.size - s->heap.oldGenSize));
+}
+
+bool shouldStartConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  if (not useConcurrentMark (s) or cm->active)
+    return FALSE;
+  /* Until the first major GC, measure from the first minor GC. */
+  if (0 == cm->triggerSize)
+    setConcurrentMarkTrigger (s);
+  return s->heap.oldGenSize > cm->triggerSize;
+}
+
+/* Start a cycle.  This must follow a minor GC, so that every object
+ * reachable from the roots is below the mark limit.
+ */
+void startConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+  struct GC_parallelState *ps;
+  struct GC_worker *w;
+
+  cm = &s->concurrentMark;
+  ps = &s->parallelState;
+  w = &cm->worker;
+  /* The mark only covers the old generation. */
+  releaseSurvivorSpaces (s);
+  unless (allocMarkMaps (s, s->heap.size))
+    return;
+  cm->modUnionMapSize =
+    align (s->generationalMaps.cardMapLength * CARD_MAP_ELEM_SIZE,
+           s->sysvals.pageSize);
+  cm->modUnionMap = GC_mmapAnon (NULL, cm->modUnionMapSize);
+  if ((void*)-1 == cm->modUnionMap) {
+    if (DEBUG_CONCURRENT_MARK or s->controls.messages)
+      fprintf (stderr,
+               "[GC: Unable to allocate %s bytes of mod-union map.]\n",
+               uintmaxToCommaString(cm->modUnionMapSize));
+    cm->modUnionMap = NULL;
+    freeMarkMaps (s);
+    return;
+  }
+  if (cm->incremental)
+    s->cumulativeStatistics.numIncrementalMarks++;
+  else
+    s->cumulativeStatistics.numConcurrentMarks++;
+  startLargeObjectMark (s);
+  if (DEBUG_CONCURRENT_MARK or s->controls.messages)
+    fprintf (stderr,
+             "[GC: Starting %s mark of %s bytes.]\n",
+             cm->incremental ? "incremental" : "concurrent",
+             uintmaxToCommaString(s->heap.oldGenSize));
+  cm->limit = s->heap.start + s->heap.oldGenSize;
+  ps->markLimit = cm->limit;
+  *(cm->state) = *s;
+  cm->state->worker = w;
+  w->bytesMarked = 0;
+  w->markStackSize = 0;
+  w->weaks = NULL;
+  cm->stacksSize = 0;
+  cm->cleanCard = 0;
+  foreachGlobalObjptr (cm->state, markObjptrParallel);
+  cm->active = TRUE;
+  cm->cancel = FALSE;
+  cm->remarked = FALSE;
+  if (cm->incremental) {
+    cm->marking = TRUE;
+    return;
+  }
+  unless (cm->started and cm->pid == getpid ())
+    startConcurrentMarker (s);
+  pthread_mutex_lock (&cm->lock);
+  __atomic_store_n (&cm->marking, TRUE, __ATOMIC_RELEASE);
+  pthread_cond_signal (&cm->wake);
+  pthread_mutex_unlock (&cm->lock);
+}
+
+/* Wait for the background thread to stop marking, or finish the
+ * slices of an incremental mark without a bound.  Returns FALSE if
+ * the cycle had to be abandoned because this is a child process, to
+ * which the background thread was not inherited.
+ */
+bool waitForConcurrentMarker (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  assert (cm->active);
+  if (cm->incremental) {
+    drainMarkStackConcurrent (cm);
+    cm->marking = FALSE;
+    return TRUE;
+  }
+  unless (cm->pid == getpid ()) {
+    cm->marking = FALSE;
+    cm->started = FALSE;
+    endConcurrentMark (s);
+    return FALSE;
+  }
+  pthread_mutex_lock (&cm->lock);
+  while (cm->marking)
+    pthread_cond_wait (&cm->done, &cm->lock);
+  pthread_mutex_unlock (&cm->lock);
+  return TRUE;
+}
+
+void endConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  unless (NULL == s->parallelState.liveMap)
+    freeMarkMaps (s);
+  GC_release (cm->modUnionMap, cm->modUnionMapSize);
+  cm->modUnionMap = NULL;
+  cm->active = FALSE;
+  cm->remarked = FALSE;
+}
+
+/* Stop the cycle, if any, and discard its marks.  Used before the
+ * heap is changed other than by a GC.
+ */
+void cancelConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  unless (cm->active)
+    return;
+  __atomic_store_n (&cm->cancel, TRUE, __ATOMIC_RELAXED);
+  if (waitForConcurrentMarker (s))
+    endConcurrentMark (s);
+  if (DEBUG_CONCURRENT_MARK or s->controls.messages)
+    fprintf (stderr, "[GC: Cancelled concurrent mark.]\n");
+}
+
+/* ---------------------------------------------------------------- */
+/*                            Remark                                */
+/* ---------------------------------------------------------------- */
+
+/* Save the cards marked since the last GC. */
+void mergeCardMapForConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+  GC_cardMapElem *cardMap;
+  size_t numCards;
+
+  cm = &s->concurrentMark;
+  cardMap = s->generationalMaps.cardMap;
+  numCards =
+    sizeToCardMapIndex (align ((size_t)(cm->limit - s->heap.start), CARD_SIZE));
+  for (size_t i = 0; i < numCards; i++)
+    cm->modUnionMap[i] |= cardMap[i];
+}
+
+/* Mark the objects pointed to by the object at p, which is on a dirty
+ * card.  An unmarked object will be scanned if it is marked, a stack
+ * is rescanned in full, and a weak has been linked already.
+ */
+void rescanObjectForConcurrentMark (GC_state s, pointer p) {
+  GC_objectTypeTag tag;
+
+  unless (isPointerMarkedParallel (s, p))
+    return;
+  splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+  if (STACK_TAG == tag or WEAK_TAG == tag)
+    return;
+  foreachObjptrInObject (s, p, markObjptrParallel, TRUE);
+}
+
+/* Walk through the cards below the mark limit of the cycle, as in
+ * forwardInterGenerationalObjptrs, and rescan the objects on the
+ * cards marked during the cycle, clearing them.  The walk starts at
+ * cm->cleanCard.  With a non-zero deadline, returns FALSE if the
+ * deadline passed before the walk was done, leaving cm->cleanCard
+ * where the next walk should resume.
+ */
+bool rescanDirtyCardsForConcurrentMark (GC_state s, uintmax_t deadline) {
+  struct GC_concurrentMark *cm;
+  GC_crossMapElem *crossMap;
+  size_t cardIndex, firstCardIndex, maxCardIndex;
+  pointer cardStart, cardEnd, objectStart;
+
+  cm = &s->concurrentMark;
+  crossMap = s->generationalMaps.crossMap;
+  maxCardIndex =
+    sizeToCardMapIndex (align ((size_t)(cm->limit - s->heap.start), CARD_SIZE));
+  if (0 == cm->cleanCard)
+    objectStart = alignFrontier (s, s->heap.start);
+  else
+    objectStart = cm->cleanObject;
+  cardIndex = cm->cleanCard;
+  firstCardIndex = cardIndex;
+  while (cardIndex < maxCardIndex and objectStart < cm->limit) {
+    if (0 != deadline
+        and cardIndex != firstCardIndex
+        and 0 == cardIndex % GC_INCREMENTAL_MARK_CHECK
+        and GC_getMonotonicTime () >= deadline) {
+      cm->cleanCard = cardIndex;
+      cm->cleanObject = objectStart;
+      return FALSE;
+    }
+    cardStart = s->heap.start + cardMapIndexToSize (cardIndex);
+    if (cm->modUnionMap[cardIndex]) {
+      cm->modUnionMap[cardIndex] = 0;
+      cardEnd = cardStart + CARD_SIZE;
+      if (cm->limit < cardEnd)
+        cardEnd = cm->limit;
+      while (objectStart < cardEnd) {
+        pointer p;
+
+        p = advanceToObjectData (s, objectStart);
+        objectStart += sizeofObject (s, p);
+        rescanObjectForConcurrentMark (s, p);
+      }
+      cardIndex = sizeToCardMapIndex ((size_t)(objectStart - s->heap.start));
+    } else {
+      unless (CROSS_MAP_EMPTY == crossMap[cardIndex])
+        objectStart = cardStart + (size_t)(crossMap[cardIndex] * CROSS_MAP_OFFSET_SCALE);
+      cardIndex++;
+    }
+  }
+  cm->cleanCard = 0;
+  return TRUE;
+}
+
+void remarkConcurrentJob (GC_state s) {
+  if (0 == s->worker->id) {
+    struct GC_concurrentMark *cm;
+
+    cm = &s->concurrentMark;
+    foreachGlobalObjptr (s, markObjptrParallel);
+    for (size_t i = 0; i < cm->stacksSize; i++)
+      scanObjectForParallelMark (s, cm->stacks[i]);
+    rescanDirtyCardsForConcurrentMark (s, 0);
+  }
+  drainMarkStackParallel (s);
+}
+
+/* Finish the mark of the current cycle, with the world stopped and
+ * the nursery empty, and clear the weaks to unmarked objects.
+ * Everything reachable is marked, including objects above the mark
+ * limit of the background thread.  Returns FALSE if the cycle was
+ * abandoned instead.
+ */
+bool finishConcurrentMark (GC_state s) {
+  struct GC_concurrentMark *cm;
+  struct GC_parallelState *ps;
+  uintmax_t bytesMarked;
+
+  cm = &s->concurrentMark;
+  ps = &s->parallelState;
+  assert (cm->active);
+  if (cm->remarked)
+    return TRUE;
+  if (__atomic_load_n (&cm->marking, __ATOMIC_ACQUIRE)) {
+    cm->slices = min (2 * cm->slices, GC_INCREMENTAL_MARK_MAX_SLICES);
+    cm->trigger *= GC_CONCURRENT_MARK_TRIGGER_SHRINK;
+  } else {
+    cm->slices = max (cm->slices / 2, GC_INCREMENTAL_MARK_MIN_SLICES);
+    cm->trigger = min (cm->trigger * GC_CONCURRENT_MARK_TRIGGER_GROW,
+                       GC_CONCURRENT_MARK_TRIGGER_MAX);
+  }
+  unless (waitForConcurrentMarker (s))
+    return FALSE;
+  clearSafepointRequest (s, GC_SAFEPOINT_REMARK);
+  cm->cleanCard = 0;
+  mergeCardMapForConcurrentMark (s);
+  updateCrossMap (s);
+  ps->markLimit = s->heap.start + s->heap.oldGenSize;
+  setMarkRegions (s, s->heap.oldGenSize);
+  ps->currentStack = getStackCurrent (s);
+  ps->numActive = ps->numThreads;
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    w->bytesMarked = 0;
+    w->markStackSize = 0;
+    w->weaks = NULL;
+  }
+  runParallel (s, remarkConcurrentJob);
+  bytesMarked = cm->worker.bytesMarked;
+  while (cm->worker.weaks != NULL) {
+    GC_weak weak = cm->worker.weaks;
+
+    cm->worker.weaks = weak->link;
+    weak->link = s->weaks;
+    s->weaks = weak;
+  }
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    assert (isWorkDequeEmpty (&w->deque));
+    bytesMarked += w->bytesMarked;
+    while (w->weaks != NULL) {
+      GC_weak weak = w->weaks;
+
+      w->weaks = weak->link;
+      weak->link = s->weaks;
+      s->weaks = weak;
+    }
+  }
+  updateWeaksForParallelMarkCompact (s);
+  cm->bytesLive = (size_t)bytesMarked;
+  cm->remarked = TRUE;
+  if (DEBUG_CONCURRENT_MARK or s->controls.messages)
+    fprintf (stderr,
+             "[GC: Finished %s mark; %s of %s bytes are live, %s bytes remarked.]\n",
+             cm->incremental ? "incremental" : "concurrent",
+             uintmaxToCommaString(cm->bytesLive),
+             uintmaxToCommaString(s->heap.oldGenSize),
+             uintmaxToCommaString(bytesMarked - cm->worker.bytesMarked));
+  return TRUE;
+}
+
+bool isConcurrentCompactWorthwhile (GC_state s) {
+  return s->concurrentMark.bytesLive
+         <= s->heap.oldGenSize
+            - s->heap.oldGenSize / GC_CONCURRENT_MARK_GARBAGE_RATIO;
+}
+
+/* ---------------------------------------------------------------- */
+/*                        Incremental Slices                        */
+/* ---------------------------------------------------------------- */
+
+bool isIncrementalMarkPending (GC_state s) {
+  struct GC_concurrentMark *cm;
+
+  cm = &s->concurrentMark;
+  return cm->incremental and cm->active and cm->marking;
+}
+
+/* Mark until the pause that began at start (in microseconds) reaches
+ * the pause target.  A slice that follows a minor GC raises the mark
+ * limit to the end of the old generation and, once the gray objects
+ * are gone, precleans the dirty cards.  Any other slice may find
+ * objects in the nursery, so it only scans gray objects.  Clearing a
+ * dirty card is only safe when every object that the objects on it
+ * point to is below the mark limit.
+ */
+void markIncrementalSlice (GC_state s, uintmax_t start, bool afterMinor) {
+  struct GC_concurrentMark *cm;
+  struct GC_worker *w;
+  uintmax_t deadline;
+  size_t numScanned;
+
+  cm = &s->concurrentMark;
+  w = &cm->worker;
+  assert (isIncrementalMarkPending (s));
+  assert (NULL == s->worker);
+  s->cumulativeStatistics.numMarkSlices++;
+  deadline = start + 1000 * s->controls.maxPause;
+  if (afterMinor) {
+    updateCrossMap (s);
+    cm->limit = s->heap.start + s->heap.oldGenSize;
+    s->parallelState.markLimit = cm->limit;
+  }
+  s->worker = w;
+  numScanned = 0;
+  while (TRUE) {
+    while (w->markStackSize > 0) {
+      GC_objectTypeTag tag;
+      pointer p;
+
+      p = w->markStack[--w->markStackSize];
+      splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+      if (STACK_TAG == tag)
+        deferStackForConcurrentMark (cm, p);
+      else
+        scanObjectForParallelMark (s, p);
+      if (0 == ++numScanned % GC_INCREMENTAL_MARK_CHECK
+          and GC_getMonotonicTime () >= deadline)
+        goto done;
+    }
+    unless (afterMinor
+            and rescanDirtyCardsForConcurrentMark (s, deadline))
+      goto done;
+    if (0 == w->markStackSize) {
+      cm->marking = FALSE;
+      goto done;
+    }
+  }
+done:
+  s->worker = NULL;
+  if (DEBUG_CONCURRENT_MARK)
+    fprintf (stderr,
+             "[GC: Incremental mark slice; %s bytes marked, %s gray objects left.]\n",
+             uintmaxToCommaString(w->bytesMarked),
+             uintmaxToCommaString(w->markStackSize));
+}
+
+/* Lower the limit on leaving the runtime, so that the mutator traps
+ * for the next slice after allocating its share of the nursery.
+ * Every entry to the runtime restores the limit; see beginAtomic.
+ * A nested leave keeps the limit for the invariant of the outer one.
+ */
+void setIncrementalMarkLimit (GC_state s) {
+  pointer limit;
+
+  unless (1 == s->atomicState
+          and isIncrementalMarkPending (s)
+          and s->concurrentMark.worker.markStackSize > 0)
+    return;
+  limit = s->frontier
+          + (size_t)(s->limitPlusSlop - s->heap.nursery) / s->concurrentMark.slices;
+  if (limit < s->limit)
+    s->limit = limit;
+}
@@ -0,0 +1,127 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A concurrent mark marks the old generation into the parallel
+ * mark-compact's bitmaps (see parallel-mark-compact.h) on a background
+ * thread while the mutator runs.  A cycle starts at the end of a GC,
+ * when the nursery is empty, by marking from the roots everything
+ * below the end of the old generation, which becomes the mark limit.
+ *
+ * The mark is an incremental-update mark that uses the card map as
+ * its write barrier.  A card marked by the mutator during the cycle
+ * is saved in the mod-union map before each GC clears the card map.
+ * Objects that are allocated or promoted during the cycle lie above
+ * the mark limit, and are not marked by the background thread.
+ * Stacks, which the mutator writes without marking cards, are marked
+ * but not scanned.
+ *
+ * Once the background thread is done, it stops the mutator at a
+ * safepoint (see safepoint.h), unless a GC comes first, and the GC
+ * there finishes the mark with the world stopped: it rescans the
+ * roots, the stacks, and the marked objects on dirty cards, and marks
+ * everything reachable above the old mark limit.  It then decides
+ * whether enough of the old generation is garbage to compact it.
+ *
+ * With a pause target (max-pause-ms) and without concurrent-mark, a
+ * cycle is an incremental mark instead: there is no background
+ * thread, and the mutator's thread marks in slices that are bounded
+ * by the pause target.  A slice follows each minor GC, and the limit
+ * is lowered so that the mutator traps for another slice after it
+ * has allocated 1 / slices of the nursery.  After a minor GC,
+ * everything is below the end of the old generation, to which the
+ * mark limit is raised; once the gray objects are gone, a slice also
+ * rescans the marked objects on dirty cards, resuming the walk
+ * through the cards where the last slice stopped, so that little is
+ * left for the remark.
+ */
+struct GC_concurrentMark {
+  bool active; /* A cycle is in progress; the mark maps are allocated. */
+  size_t bytesLive; /* Bytes marked by the remark. */
+  bool cancel; /* Asks the background thread to stop early. */
+  size_t cleanCard; /* Where a walk through the dirty cards resumes. */
+  pointer cleanObject;
+  pthread_cond_t done;
+  bool incremental; /* Mark in slices rather than on a background thread. */
+  pointer limit; /* Mark limit of the background thread. */
+  pthread_mutex_t lock;
+  bool marking; /* The background thread is running, or slices remain. */
+  GC_cardMapElem *modUnionMap; /* Cards marked during the cycle. */
+  size_t modUnionMapSize;
+  pid_t pid; /* Process that started the thread; see runParallel. */
+  bool remarked; /* The mark is complete. */
+  size_t slices; /* Slices of an incremental mark per nursery. */
+  pointer *stacks; /* Stacks marked by the background thread. */
+  size_t stacksCapacity;
+  size_t stacksSize;
+  bool started;
+  GC_state state; /* The background thread's copy of the GC_state. */
+  pthread_t thread;
+  float trigger; /* Fraction of the free space to fill before a cycle. */
+  size_t triggerSize; /* Start a cycle when the old generation is larger. */
+  pthread_cond_t wake;
+  struct GC_worker worker;
+};
+
+/* A concurrent mark only compacts the old generation if at least
+ * 1 / GC_CONCURRENT_MARK_GARBAGE_RATIO of it is garbage.
+ */
+#define GC_CONCURRENT_MARK_GARBAGE_RATIO 4
+
+/* A cycle starts once the old generation has filled the fraction
+ * trigger of the space that was free after the last one.  A cycle
+ * that is still marking when a GC has to finish it multiplies trigger
+ * by GC_CONCURRENT_MARK_TRIGGER_SHRINK, so that the next cycle starts
+ * earlier; any other multiplies it by GC_CONCURRENT_MARK_TRIGGER_GROW,
+ * up to GC_CONCURRENT_MARK_TRIGGER_MAX.
+ */
+#define GC_CONCURRENT_MARK_TRIGGER_GROW 1.25f
+#define GC_CONCURRENT_MARK_TRIGGER_MAX 0.5f
+#define GC_CONCURRENT_MARK_TRIGGER_SHRINK 0.5f
+
+/* An incremental mark adjusts slices like trigger, doubling it for a
+ * cycle that a GC has to finish and halving it otherwise, between
+ * GC_INCREMENTAL_MARK_MIN_SLICES and GC_INCREMENTAL_MARK_MAX_SLICES.
+ * A slice checks the clock after scanning every
+ * GC_INCREMENTAL_MARK_CHECK objects or clean cards.
+ */
+#define GC_INCREMENTAL_MARK_CHECK 256
+#define GC_INCREMENTAL_MARK_MAX_SLICES 4096
+#define GC_INCREMENTAL_MARK_MIN_SLICES 8
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initConcurrentMark (GC_state s);
+static inline bool useConcurrentMark (GC_state s);
+static inline bool isConcurrentMarkActive (GC_state s);
+static bool isConcurrentMarkDone (GC_state s);
+static void *concurrentMarker (void *arg);
+static void startConcurrentMarker (GC_state s);
+static void deferStackForConcurrentMark (struct GC_concurrentMark *cm, pointer p);
+static void drainMarkStackConcurrent (struct GC_concurrentMark *cm);
+
+static void setConcurrentMarkTrigger (GC_state s);
+static bool shouldStartConcurrentMark (GC_state s);
+static void startConcurrentMark (GC_state s);
+static bool waitForConcurrentMarker (GC_state s);
+static void endConcurrentMark (GC_state s);
+static void cancelConcurrentMark (GC_state s);
+
+static void mergeCardMapForConcurrentMark (GC_state s);
+static void rescanObjectForConcurrentMark (GC_state s, pointer p);
+static bool rescanDirtyCardsForConcurrentMark (GC_state s, uintmax_t deadline);
+static void remarkConcurrentJob (GC_state s);
+static bool finishConcurrentMark (GC_state s);
+static inline bool isConcurrentCompactWorthwhile (GC_state s);
+
+static inline bool isIncrementalMarkPending (GC_state s);
+static void markIncrementalSlice (GC_state s, uintmax_t start, bool afterMinor);
+static void setIncrementalMarkLimit (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -37,19 +37,71 @@ struct GC_ratios {
   float stackCurrentShrink;
   float stackMaxReserved;
   float stackShrink;
+  /* Each survivor space is 1 / survivor of the heap. */
+  float survivor;
 };
 
+/* How the pages of a heap that shrinks are given back; see shrinkHeap. */
+typedef enum {
+  GC_HEAP_RELEASE_UNMAP,
+  GC_HEAP_RELEASE_FREE, /* GC_discard lazily, within the reservation. */
+  GC_HEAP_RELEASE_DONTNEED, /* GC_discard at once, within the reservation. */
+} GC_heapRelease;
+
+/* How the heap and its card/cross maps are mapped; see mapHeap. */
+typedef enum {
+  GC_HUGE_PAGES_NONE,
+  GC_HUGE_PAGES_TRANSPARENT, /* madvise (MADV_HUGEPAGE), aligned to a huge page. */
+  GC_HUGE_PAGES_EXPLICIT, /* MAP_HUGETLB, else as for transparent. */
+} GC_hugePages;
+
+typedef enum {
+  GC_NUMA_POLICY_DEFAULT,
+  GC_NUMA_POLICY_INTERLEAVE, /* Across the nodes the process may use. */
+  GC_NUMA_POLICY_LOCAL, /* On the node of the thread that touches the page. */
+} GC_numaPolicy;
+
+/* How profiles are written; see profileWrite. */
+typedef enum {
+  GC_PROFILE_FORMAT_MLMON, /* For mlprof. */
+  GC_PROFILE_FORMAT_COLLAPSED, /* A line of source names and a count per sequence. */
+} GC_profileFormat;
+
 struct GC_controls {
+  bool adaptiveNursery; /* Size the nursery from the survival of minor GCs. */
+  size_t allocSampleBytes; /* If 0, then no allocation sampling. */
+  const char *allocSampleFile;
+  bool compressWorld; /* Save worlds as compressed chunks. */
+  bool concurrentMark; /* Mark the old generation while the mutator runs. */
+  bool deltaWorld; /* Save worlds as deltas of the last world. */
   size_t fixedHeap; /* If 0, then no fixed heap. */
+  const char *gcLog; /* If NULL, then no GC log. */
+  uint32_t gcThreads; /* Number of threads used by GCs. */
+  uint32_t heapCensus; /* If 0, then no heap census; else the types listed. */
+  const char *heapCensusFile;
+  const char *heapDumpFile;
+  int heapDumpSignal; /* If 0, then no signal dumps the heap. */
+  GC_heapRelease heapRelease;
+  GC_hugePages hugePages;
+  size_t largeObjectSize; /* If 0, then no large-object space. */
+  bool mapWorld; /* Map the heap image of a loaded world from its file. */
+  bool markRegion; /* Keep the dense blocks of the old generation in place. */
   size_t maxHeap; /* if zero, then unlimited, else limit total heap */
+  uintmax_t maxMinorPause; /* In ms; if 0, then no minor GC pause target. */
+  uintmax_t maxPause; /* In ms; if 0, then no pause target. */
   bool mayLoadWorld;
   bool mayPageHeap; /* Permit paging heap to disk during GC */
   bool mayProcessAtMLton;
   bool messages; /* Print a message at the start and end of each gc. */
+  GC_numaPolicy numaPolicy;
   size_t oldGenArraySize; /* Arrays larger are allocated in old gen, if possible. */
+  GC_profileFormat profileFormat;
   struct GC_ratios ratios;
+  bool reserveHeap; /* Reserve the address space of the largest heap. */
   bool rusageMeasureGC;
+  const char *statsSegment; /* If NULL, then no stats segment. */
   bool summary; /* Print a summary of gc info when program exits. */
+  uint32_t tenuringThreshold; /* If 0, then no survivor spaces. */
 };
 
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
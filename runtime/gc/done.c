@@ -37,6 +37,18 @@ static void displayCollectionStats (FILE *out, const char *name, struct rusage *
   fprintf (out, "\n");
 }
 
+static void displayPauseHistogram (FILE *out, const char *name,
+                                   struct GC_pauseHistogram *h) {
+  fprintf (out, "%s", name);
+  displayCol (out, 7, uintmaxToCommaString (h->num));
+  displayCol (out, 7, uintmaxToCommaString (pauseHistogramPercentile (h, 50.0)));
+  displayCol (out, 7, uintmaxToCommaString (pauseHistogramPercentile (h, 90.0)));
+  displayCol (out, 7, uintmaxToCommaString (pauseHistogramPercentile (h, 99.0)));
+  displayCol (out, 7, uintmaxToCommaString (pauseHistogramPercentile (h, 99.9)));
+  displayCol (out, 7, uintmaxToCommaString (h->max));
+  fprintf (out, "\n");
+}
+
 void GC_done (GC_state s) {
   FILE *out;
 
@@ -77,6 +89,17 @@ void GC_done (GC_state s) {
              : 100.0 * ((double) gcTime) / (double)totalTime);
     fprintf (out, "max pause time: %s ms\n",
              uintmaxToCommaString (s->cumulativeStatistics.maxPauseTime));
+    fprintf (out, "pause us\t number\t    p50\t    p90\t    p99\t  p99.9\t    max\n");
+    fprintf (out, "-------------\t-------\t-------\t-------\t-------\t-------\t-------\n");
+    displayPauseHistogram
+      (out, "copying\t\t",
+       &s->cumulativeStatistics.pauses[GC_PAUSE_COPYING]);
+    displayPauseHistogram
+      (out, "mark-compact\t",
+       &s->cumulativeStatistics.pauses[GC_PAUSE_MARK_COMPACT]);
+    displayPauseHistogram
+      (out, "minor\t\t",
+       &s->cumulativeStatistics.pauses[GC_PAUSE_MINOR]);
     fprintf (out, "total bytes allocated: %s bytes\n",
              uintmaxToCommaString (s->cumulativeStatistics.bytesAllocated));
     fprintf (out, "max bytes live: %s bytes\n",
@@ -91,7 +114,47 @@ void GC_done (GC_state s) {
              uintmaxToCommaString (s->cumulativeStatistics.bytesScannedMinor));
     fprintf (out, "bytes hash consed: %s bytes\n",
              uintmaxToCommaString (s->cumulativeStatistics.bytesHashConsed));
+    if (s->controls.concurrentMark)
+      fprintf (out, "num concurrent marks: %s\n",
+               uintmaxToCommaString (s->cumulativeStatistics.numConcurrentMarks));
+    if (s->concurrentMark.incremental) {
+      fprintf (out, "num incremental marks: %s\n",
+               uintmaxToCommaString (s->cumulativeStatistics.numIncrementalMarks));
+      fprintf (out, "num mark slices: %s\n",
+               uintmaxToCommaString (s->cumulativeStatistics.numMarkSlices));
+    }
+    if (s->controls.largeObjectSize > 0) {
+      fprintf (out, "num large objects: %s\n",
+               uintmaxToCommaString (s->cumulativeStatistics.numLargeObjects));
+      fprintf (out, "bytes in large objects: %s bytes\n",
+               uintmaxToCommaString (s->cumulativeStatistics.bytesLargeObjects));
+    }
+    if (s->controls.markRegion)
+      fprintf (out, "bytes copied into holes: %s bytes\n",
+               uintmaxToCommaString (s->cumulativeStatistics.bytesCopiedToHoles));
+    if (s->controls.tenuringThreshold > 0)
+      fprintf (out, "bytes copied into survivor spaces: %s bytes\n",
+               uintmaxToCommaString (s->cumulativeStatistics.bytesCopiedToSurvivors));
+    if (GC_HEAP_RELEASE_UNMAP != s->controls.heapRelease
+        or s->controls.reserveHeap)
+      fprintf (out, "bytes discarded: %s bytes\n",
+               uintmaxToCommaString (s->cumulativeStatistics.bytesDiscarded));
+    if (useAllocSampler (s))
+      fprintf (out, "num allocation samples: %s\n",
+               uintmaxToCommaString (s->allocSampler.samples));
+    if (useParallelGC (s)) {
+      for (uint32_t i = 0; i < s->parallelState.numThreads; i++)
+        fprintf (out, "bytes copied by GC thread %"PRIu32": %s bytes\n",
+                 i, uintmaxToCommaString (s->cumulativeStatistics.bytesCopiedByThread[i]));
+    }
+    displayHeapPages (s, &s->heap, out);
   }
+  if (useAllocSampler (s))
+    writeAllocSamples (s, s->controls.allocSampleFile);
+  closeEventLog (s);
+  closeHeapCensus (s);
+  closeStatsSegment (s);
+  cancelConcurrentMark (s);
   releaseHeap (s, &s->heap);
   releaseHeap (s, &s->secondaryHeap);
 }
@@ -17,6 +17,8 @@ void enter (GC_state s) {
   /* used needs to be set because the mutator has changed s->stackTop. */
   getStackCurrent(s)->used = sizeofGCStateCurrentStackUsed (s);
   getThreadCurrent(s)->exnStack = s->exnStack;
+  countAllocSampleBytes (s);
+  takeAllocSample (s);
   if (DEBUG) 
     displayGCState (s, stderr);
   beginAtomic (s);
@@ -32,6 +34,8 @@ void leave (GC_state s) {
    * for functions that don't ensureBytesFree.
    */
   assert (invariantForMutator (s, FALSE, TRUE));
+  setIncrementalMarkLimit (s);
+  setAllocSampleLimit (s);
   endAtomic (s);
   if (DEBUG)
     fprintf (stderr, "leave ok\n");
@@ -0,0 +1,105 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initEventLog (GC_state s) {
+  s->eventLog.bytesAllocated = 0;
+  s->eventLog.f = NULL;
+  if (NULL == s->controls.gcLog)
+    return;
+  s->eventLog.f = fopen_safe (s->controls.gcLog, "w");
+}
+
+bool useEventLog (GC_state s) {
+  return NULL != s->eventLog.f;
+}
+
+void beginEventLog (GC_state s) {
+  struct GC_eventLog *el;
+  struct timeval tv;
+
+  unless (useEventLog (s))
+    return;
+  el = &s->eventLog;
+  gettimeofday (&tv, NULL);
+  el->start = 1000000 * (uintmax_t)tv.tv_sec + (uintmax_t)tv.tv_usec;
+  el->bytesCopied = s->cumulativeStatistics.bytesCopied;
+  el->bytesCopiedMinor = s->cumulativeStatistics.bytesCopiedMinor;
+  el->bytesMarkCompacted = s->cumulativeStatistics.bytesMarkCompacted;
+  el->heapSize = s->heap.size;
+  el->numCardsMarked = s->cumulativeStatistics.numCardsMarked;
+  el->numCopyingGCs = s->cumulativeStatistics.numCopyingGCs;
+  el->numMarkCompactGCs = s->cumulativeStatistics.numMarkCompactGCs;
+  el->numMarkSlices = s->cumulativeStatistics.numMarkSlices;
+  el->numMinorGCs = s->cumulativeStatistics.numMinorGCs;
+  el->nurseryUsed = (size_t)(s->frontier - s->heap.nursery);
+  el->oldGenSize = s->heap.oldGenSize;
+}
+
+/* endEventLog (s, pauseTime)
+ *
+ * writes the line of the collection that beginEventLog started, which
+ * paused the mutator for pauseTime microseconds.  The
+ * line is flushed, so that a program that is killed loses none of its
+ * collections.
+ */
+void endEventLog (GC_state s, uintmax_t pauseTime) {
+  struct GC_eventLog *el;
+  struct GC_cumulativeStatistics *cs;
+  const char *major;
+
+  unless (useEventLog (s))
+    return;
+  el = &s->eventLog;
+  cs = &s->cumulativeStatistics;
+  if (cs->numMarkCompactGCs > el->numMarkCompactGCs)
+    major = "\"mark-compact\"";
+  else if (cs->numCopyingGCs > el->numCopyingGCs)
+    major = "\"copying\"";
+  else
+    major = "null";
+  fprintf (el->f,
+           "{\"gc\":%"PRIuMAX",\"minor\":%s,\"major\":%s,\"markSlice\":%s"
+           ",\"start\":%"PRIuMAX",\"end\":%"PRIuMAX",\"pause\":%"PRIuMAX
+           ",\"bytesAllocated\":%"PRIuMAX
+           ",\"bytesCopiedMinor\":%"PRIuMAX
+           ",\"bytesCopied\":%"PRIuMAX
+           ",\"bytesMarkCompacted\":%"PRIuMAX,
+           cs->numGCs,
+           (cs->numMinorGCs > el->numMinorGCs) ? "true" : "false",
+           major,
+           (cs->numMarkSlices > el->numMarkSlices) ? "true" : "false",
+           el->start, el->start + pauseTime, pauseTime,
+           cs->bytesAllocated - el->bytesAllocated,
+           cs->bytesCopiedMinor - el->bytesCopiedMinor,
+           cs->bytesCopied - el->bytesCopied,
+           cs->bytesMarkCompacted - el->bytesMarkCompacted);
+  if (cs->numMarkCompactGCs == el->numMarkCompactGCs
+      and cs->numCopyingGCs == el->numCopyingGCs)
+    fprintf (el->f, ",\"bytesLive\":null");
+  else
+    fprintf (el->f, ",\"bytesLive\":%"PRIuMAX,
+             (uintmax_t)s->lastMajorStatistics.bytesLive);
+  fprintf (el->f,
+           ",\"cardsMarked\":%"PRIuMAX
+           ",\"nurseryUsed\":%"PRIuMAX
+           ",\"nurserySize\":%"PRIuMAX
+           ",\"oldGenSizeBefore\":%"PRIuMAX",\"oldGenSizeAfter\":%"PRIuMAX
+           ",\"heapSizeBefore\":%"PRIuMAX",\"heapSizeAfter\":%"PRIuMAX"}\n",
+           cs->numCardsMarked - el->numCardsMarked,
+           (uintmax_t)el->nurseryUsed,
+           (uintmax_t)(s->heap.size - (size_t)(s->heap.nursery - s->heap.start)),
+           (uintmax_t)el->oldGenSize, (uintmax_t)s->heap.oldGenSize,
+           (uintmax_t)el->heapSize, (uintmax_t)s->heap.size);
+  fflush (el->f);
+  el->bytesAllocated = cs->bytesAllocated;
+}
+
+void closeEventLog (GC_state s) {
+  unless (useEventLog (s))
+    return;
+  fclose_safe (s->eventLog.f);
+  s->eventLog.f = NULL;
+}
@@ -0,0 +1,42 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With gc-log, a line of JSON is written for each collection and for
+ * each slice of an incremental mark between collections, giving its
+ * kind, when it started and ended, and how the statistics and the
+ * heap changed over it.  A GC_eventLog holds the values at the start
+ * of the collection being logged.
+ */
+struct GC_eventLog {
+  uintmax_t bytesAllocated; /* At the end of the last collection. */
+  uintmax_t bytesCopied;
+  uintmax_t bytesCopiedMinor;
+  uintmax_t bytesMarkCompacted;
+  FILE *f; /* NULL unless gc-log. */
+  size_t heapSize;
+  uintmax_t numCardsMarked;
+  uintmax_t numCopyingGCs;
+  uintmax_t numMarkCompactGCs;
+  uintmax_t numMarkSlices;
+  uintmax_t numMinorGCs;
+  size_t nurseryUsed;
+  size_t oldGenSize;
+  uintmax_t start; /* Since the epoch, in microseconds. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initEventLog (GC_state s);
+static inline bool useEventLog (GC_state s);
+static void beginEventLog (GC_state s);
+static void endEventLog (GC_state s, uintmax_t pauseTime);
+static void closeEventLog (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
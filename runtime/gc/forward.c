@@ -23,6 +23,93 @@ bool isObjptrInToSpace (GC_state s, objptr op) {
 }
 #endif
 
+/* sizeofObjectForForward (s, p, header, &headerBytes, &skip)
+ * Returns the number of bytes, including the header, to copy when
+ * forwarding the object p with the given header, and the number of
+ * bytes of unused stack space to skip after it.  Shrinks p if it is a
+ * stack with too much space reserved.
+ */
+size_t sizeofObjectForForward (GC_state s, pointer p, GC_header header,
+                               size_t *headerBytesp, size_t *skipp) {
+  size_t headerBytes, objectBytes, skip;
+  GC_objectTypeTag tag;
+  uint16_t bytesNonObjptrs, numObjptrs;
+
+  splitHeader(s, header, &tag, NULL, &bytesNonObjptrs, &numObjptrs);
+
+  /* Compute the space taken by the header and object body. */
+  if ((NORMAL_TAG == tag) or (WEAK_TAG == tag)) { /* Fixed size object. */
+    headerBytes = GC_NORMAL_HEADER_SIZE;
+    objectBytes = bytesNonObjptrs + (numObjptrs * OBJPTR_SIZE);
+    skip = 0;
+  } else if (ARRAY_TAG == tag) {
+    headerBytes = GC_ARRAY_HEADER_SIZE;
+    objectBytes = sizeofArrayNoHeader (s, getArrayLength (p),
+                                       bytesNonObjptrs, numObjptrs);
+    skip = 0;
+  } else { /* Stack. */
+    bool current;
+    size_t reservedNew;
+    GC_stack stack;
+
+    assert (STACK_TAG == tag);
+    headerBytes = GC_STACK_HEADER_SIZE;
+    stack = (GC_stack)p;
+    /* A parallel GC may already have forwarded the current thread,
+     * so it records the current stack before it starts.
+     */
+    if (NULL == s->worker)
+      current = getStackCurrent(s) == stack;
+    else
+      current = s->worker->parallel->currentStack == stack;
+
+    reservedNew = sizeofStackShrinkReserved (s, stack, current);
+    if (reservedNew < stack->reserved) {
+      if (DEBUG_STACKS or s->controls.messages)
+        fprintf (stderr,
+                 "[GC: Shrinking stack of size %s bytes to size %s bytes, using %s bytes.]\n",
+                 uintmaxToCommaString(stack->reserved),
+                 uintmaxToCommaString(reservedNew),
+                 uintmaxToCommaString(stack->used));
+      stack->reserved = reservedNew;
+    }
+    objectBytes = sizeof (struct GC_stack) + stack->used;
+    skip = stack->reserved - stack->used;
+  }
+  *headerBytesp = headerBytes;
+  *skipp = skip;
+  return headerBytes + objectBytes;
+}
+
+/* If the object copied to newp has a valid weak pointer, link it into
+ * weaksp for update after the copying GC is done.
+ */
+void linkWeakForForward (GC_state s, pointer newp, GC_header header,
+                         GC_weak *weaksp) {
+  GC_objectTypeTag tag;
+  uint16_t numObjptrs;
+  GC_weak w;
+
+  splitHeader(s, header, &tag, NULL, NULL, &numObjptrs);
+  unless ((WEAK_TAG == tag) and (numObjptrs == 1))
+    return;
+  w = (GC_weak)(newp + offsetofWeak (s));
+  if (DEBUG_WEAK)
+    fprintf (stderr, "forwarding weak "FMTPTR" ",
+             (uintptr_t)w);
+  if (isObjptr (w->objptr)
+      and (not s->forwardState.amInMinorGC
+           or isObjptrInNursery (s, w->objptr))) {
+    if (DEBUG_WEAK)
+      fprintf (stderr, "linking\n");
+    w->link = *weaksp;
+    *weaksp = w;
+  } else {
+    if (DEBUG_WEAK)
+      fprintf (stderr, "not linking\n");
+  }
+}
+
 /* forward (s, opp)
  * Forwards the object pointed to by *opp and updates *opp to point to
  * the new object.
@@ -39,77 +126,22 @@ void forwardObjptr (GC_state s, objptr *opp) {
              "forwardObjptr  opp = "FMTPTR"  op = "FMTOBJPTR"  p = "FMTPTR"\n",
              (uintptr_t)opp, op, (uintptr_t)p);
   assert (isObjptrInFromSpace (s, *opp));
+  if (isPointerInLargeObjectSpace (s, p)) {
+    markLargeObject (s, p);
+    return;
+  }
   header = getHeader (p);
   if (DEBUG_DETAILED and header == GC_FORWARDED)
     fprintf (stderr, "  already FORWARDED\n");
   if (header != GC_FORWARDED) { /* forward the object */
     size_t size, skip;
+    size_t headerBytes;
 
-    size_t headerBytes, objectBytes;
-    GC_objectTypeTag tag;
-    uint16_t bytesNonObjptrs, numObjptrs;
-
-    splitHeader(s, header, &tag, NULL, &bytesNonObjptrs, &numObjptrs);
-
-    /* Compute the space taken by the header and object body. */
-    if ((NORMAL_TAG == tag) or (WEAK_TAG == tag)) { /* Fixed size object. */
-      headerBytes = GC_NORMAL_HEADER_SIZE;
-      objectBytes = bytesNonObjptrs + (numObjptrs * OBJPTR_SIZE);
-      skip = 0;
-    } else if (ARRAY_TAG == tag) {
-      headerBytes = GC_ARRAY_HEADER_SIZE;
-      objectBytes = sizeofArrayNoHeader (s, getArrayLength (p),
-                                         bytesNonObjptrs, numObjptrs);
-      skip = 0;
-    } else { /* Stack. */
-      bool current;
-      size_t reservedNew;
-      GC_stack stack;
-
-      assert (STACK_TAG == tag);
-      headerBytes = GC_STACK_HEADER_SIZE;
-      stack = (GC_stack)p;
-      current = getStackCurrent(s) == stack;
-
-      reservedNew = sizeofStackShrinkReserved (s, stack, current);
-      if (reservedNew < stack->reserved) {
-        if (DEBUG_STACKS or s->controls.messages)
-          fprintf (stderr,
-                   "[GC: Shrinking stack of size %s bytes to size %s bytes, using %s bytes.]\n",
-                   uintmaxToCommaString(stack->reserved),
-                   uintmaxToCommaString(reservedNew),
-                   uintmaxToCommaString(stack->used));
-        stack->reserved = reservedNew;
-      }
-      objectBytes = sizeof (struct GC_stack) + stack->used;
-      skip = stack->reserved - stack->used;
-    }
-    size = headerBytes + objectBytes;
+    size = sizeofObjectForForward (s, p, header, &headerBytes, &skip);
     assert (s->forwardState.back + size + skip <= s->forwardState.toLimit);
     /* Copy the object. */
     GC_memcpy (p - headerBytes, s->forwardState.back, size);
-    /* If the object has a valid weak pointer, link it into the weaks
-     * for update after the copying GC is done.
-     */
-    if ((WEAK_TAG == tag) and (numObjptrs == 1)) {
-      GC_weak w;
-
-      w = (GC_weak)(s->forwardState.back + GC_NORMAL_HEADER_SIZE + offsetofWeak (s));
-      if (DEBUG_WEAK)
-        fprintf (stderr, "forwarding weak "FMTPTR" ",
-                 (uintptr_t)w);
-      if (isObjptr (w->objptr)
-          and (not s->forwardState.amInMinorGC
-               or isObjptrInNursery (s, w->objptr))) {
-        if (DEBUG_WEAK)
-          fprintf (stderr, "linking\n");
-        w->link = s->weaks;
-        s->weaks = w;
-      } else {
-        if (DEBUG_WEAK)
-          fprintf (stderr, "not linking\n");
-      }
-    }
+    linkWeakForForward (s, s->forwardState.back + headerBytes, header, &s->weaks);
     /* Store the forwarding pointer in the old object. */
     *((GC_header*)(p - GC_HEADER_SIZE)) = GC_FORWARDED;
     *((objptr*)p) = pointerToObjptr (s->forwardState.back + headerBytes,
@@ -127,13 +159,84 @@ void forwardObjptr (GC_state s, objptr *opp) {
   assert (isObjptrInToSpace (s, *opp));
 }
 
+/* forwardObjptrParallel (s, opp)
+ * Like forwardObjptr, but may run concurrently in several GC threads.
+ * A thread claims an object by replacing its header with
+ * GC_FORWARDING; the other threads wait until the claimant has copied
+ * the object and replaced the header with GC_FORWARDED.
+ */
+void forwardObjptrParallel (GC_state s, objptr *opp) {
+  struct GC_worker *w;
+  objptr op;
+  pointer p;
+  GC_header *headerp;
+  GC_header header;
+
+  w = s->worker;
+  op = *opp;
+  p = objptrToPointer (op, s->heap.start);
+  if (DEBUG_DETAILED)
+    fprintf (stderr,
+             "forwardObjptrParallel  worker = %"PRIu32"  opp = "FMTPTR"  op = "FMTOBJPTR"  p = "FMTPTR"\n",
+             w->id, (uintptr_t)opp, op, (uintptr_t)p);
+  if (isPointerInLargeObjectSpace (s, p)) {
+    markLargeObject (s, p);
+    return;
+  }
+  headerp = getHeaderp (p);
+  header = __atomic_load_n (headerp, __ATOMIC_ACQUIRE);
+  while (header != GC_FORWARDED) {
+    size_t size, skip;
+    size_t headerBytes;
+    pointer back;
+    bool large;
+
+    if (header == GC_FORWARDING
+        or not __atomic_compare_exchange_n (headerp, &header, GC_FORWARDING,
+                                            FALSE, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE)) {
+      header = __atomic_load_n (headerp, __ATOMIC_ACQUIRE);
+      continue;
+    }
+    /* This thread claimed the object. */
+    size = sizeofObjectForForward (s, p, header, &headerBytes, &skip);
+    large = size + skip > GC_PARALLEL_BUFFER_SIZE / GC_PARALLEL_LARGE_RATIO;
+    if (large) {
+      back = allocToSpaceParallel (s, size + skip);
+    } else {
+      unless (size + skip <= (size_t)(w->limit - w->back)
+              and isFillableGap ((size_t)(w->limit - w->back) - (size + skip)))
+        retireWorkerBuffer (s, w);
+      back = w->back;
+      w->back += size + skip;
+    }
+    GC_memcpy (p - headerBytes, back, size);
+    *((GC_header*)(back + headerBytes - GC_HEADER_SIZE)) = header;
+    linkWeakForForward (s, back + headerBytes, header, &w->weaks);
+    /* Large objects are scanned separately, and may be stolen. */
+    if (large)
+      pushWorkRange (&w->deque, back, back + size + skip);
+    w->bytesCopied += size + skip;
+    *((objptr*)p) = pointerToObjptr (back + headerBytes,
+                                     s->forwardState.toStart);
+    __atomic_store_n (headerp, GC_FORWARDED, __ATOMIC_RELEASE);
+    break;
+  }
+  *opp = *((objptr*)p);
+  if (DEBUG_DETAILED)
+    fprintf (stderr,
+             "forwardObjptrParallel --> *opp = "FMTPTR"\n",
+             (uintptr_t)*opp);
+  assert (isObjptrInToSpace (s, *opp));
+}
+
 void forwardObjptrIfInNursery (GC_state s, objptr *opp) {
   objptr op;
   pointer p;
 
   op = *opp;
   p = objptrToPointer (op, s->heap.start);
-  if (p < s->heap.nursery)
+  if (p < s->heap.nursery or isPointerInLargeObjectSpace (s, p))
     return;
   if (DEBUG_GENERATIONAL)
     fprintf (stderr,
@@ -143,8 +246,20 @@ void forwardObjptrIfInNursery (GC_state s, objptr *opp) {
   forwardObjptr (s, opp);
 }
 
-/* Walk through all the cards and forward all intergenerational pointers. */
-void forwardInterGenerationalObjptrs (GC_state s) {
+void forwardObjptrIfInNurseryParallel (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  if (p < s->heap.nursery or isPointerInLargeObjectSpace (s, p))
+    return;
+  assert (s->heap.nursery <= p and p < s->limitPlusSlop);
+  forwardObjptrParallel (s, opp);
+}
+
+/* Walk through all the cards and forward all intergenerational
+ * pointers with f.
+ */
+void forwardInterGenerationalObjptrs (GC_state s, GC_foreachObjptrFun f) {
   GC_cardMapElem *cardMap;
   GC_crossMapElem *crossMap;
   pointer oldGenStart, oldGenEnd;
@@ -192,11 +307,13 @@ checkCard:
     /* If we ever add Weak.set, then there could be intergenerational
      * weak pointers, in which case we would need to link the weak
      * objects into s->weaks.  But for now, since there is no
-     * Weak.set, the foreachObjptrInRange will do the right thing on
-     * weaks, since the weak pointer will never be into the nursery.
+     * Weak.set, the only weaks in the old generation that point into
+     * the nursery are those that this GC has just promoted into holes
+     * (see mark-region.h), which are already linked, and those whose
+     * object is a survivor, which are kept linked (see survivor.h), so
+     * weaks are skipped.
      */
-    objectStart = foreachObjptrInRange (s, objectStart, &cardEnd,
-                                        forwardObjptrIfInNursery, FALSE);
+    objectStart = foreachObjptrInRange (s, objectStart, &cardEnd, f, TRUE);
     s->cumulativeStatistics.bytesScannedMinor += (uintmax_t)(objectStart - lastObject);
     if (objectStart == oldGenEnd)
       goto done;
@@ -223,3 +340,115 @@ done:
   if (DEBUG_GENERATIONAL)
     fprintf (stderr, "Forwarding inter-generational pointers done.\n");
 }
+
+/* Returns TRUE if any card overlapping [front, back) is marked. */
+bool isCardMarkedInRange (GC_state s, pointer front, pointer back) {
+  size_t cardIndex, maxCardIndex;
+
+  cardIndex = sizeToCardMapIndex ((size_t)(front - s->heap.start));
+  maxCardIndex = sizeToCardMapIndex ((size_t)(back - s->heap.start) - 1);
+  for ( ; cardIndex <= maxCardIndex; cardIndex++)
+    if (s->generationalMaps.cardMap[cardIndex])
+      return TRUE;
+  return FALSE;
+}
+
+/* findStripeStart (s, stripe)
+ *
+ * Returns the last object boundary in card stripe, or NULL if it has
+ * none.  Like the crossMap, a stripe covers the boundaries in
+ * (stripeStart, stripeEnd].
+ */
+pointer findStripeStart (GC_state s, size_t stripe) {
+  GC_crossMapElem *crossMap;
+  size_t cardIndex, minCardIndex;
+
+  crossMap = s->generationalMaps.crossMap;
+  minCardIndex = stripe * GC_PARALLEL_STRIPE_CARDS;
+  cardIndex = min (minCardIndex + GC_PARALLEL_STRIPE_CARDS,
+                   sizeToCardMapIndex (align (s->heap.oldGenSize, CARD_SIZE)));
+  while (cardIndex > minCardIndex) {
+    cardIndex--;
+    unless (CROSS_MAP_EMPTY == crossMap[cardIndex])
+      return s->heap.start + cardMapIndexToSize (cardIndex)
+             + (size_t)(crossMap[cardIndex] * CROSS_MAP_OFFSET_SCALE);
+  }
+  return NULL;
+}
+
+void findStripeStartsJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t stripe;
+
+  ps = s->worker->parallel;
+  while (claimRegion (ps, &stripe))
+    ps->stripeStarts[stripe] = findStripeStart (s, stripe);
+}
+
+/* forwardInterGenerationalObjptrsInStripe (s, objectStart, stripeEnd)
+ *
+ * Forward the intergenerational pointers in the objects owned by a
+ * card stripe, which are those that start in (stripeStart, stripeEnd],
+ * beginning with the first one, at objectStart.  As in
+ * forwardInterGenerationalObjptrs, an object is scanned in full if any
+ * card that it overlaps is marked, including cards in later stripes.
+ */
+void forwardInterGenerationalObjptrsInStripe (GC_state s, pointer objectStart,
+                                              pointer stripeEnd) {
+  struct GC_worker *w;
+  GC_cardMapElem *cardMap;
+  GC_crossMapElem *crossMap;
+  pointer oldGenStart, oldGenEnd;
+
+  size_t cardIndex;
+  pointer cardStart, cardEnd, objectEnd;
+
+  w = s->worker;
+  cardMap = s->generationalMaps.cardMap;
+  crossMap = s->generationalMaps.crossMap;
+  oldGenStart = s->heap.start;
+  oldGenEnd = oldGenStart + s->heap.oldGenSize;
+  assert (stripeEnd <= oldGenEnd);
+  while (objectStart < stripeEnd) {
+    assert (isFrontierAligned (s, objectStart));
+    cardIndex = sizeToCardMapIndex ((size_t)(objectStart - oldGenStart));
+    cardStart = oldGenStart + cardMapIndexToSize (cardIndex);
+    cardEnd = cardStart + CARD_SIZE;
+    if (oldGenEnd < cardEnd)
+      cardEnd = oldGenEnd;
+    if (cardMap[cardIndex]) {
+      pointer lastObject;
+
+      w->numCardsMarked++;
+      lastObject = objectStart;
+      objectStart = foreachObjptrInRange (s, objectStart, &cardEnd,
+                                          forwardObjptrIfInNurseryParallel, FALSE);
+      w->bytesScanned += (uintmax_t)(objectStart - lastObject);
+      continue;
+    }
+    /* The objects in an unmarked card can be skipped, except for the
+     * last one, which may extend into marked cards.
+     */
+    unless (CROSS_MAP_EMPTY == crossMap[cardIndex])
+      objectStart = cardStart + (size_t)(crossMap[cardIndex] * CROSS_MAP_OFFSET_SCALE);
+    if (objectStart == cardEnd)
+      continue;
+    objectEnd = objectStart + sizeofObject (s, advanceToObjectData (s, objectStart));
+    assert (cardEnd < objectEnd);
+    if (isCardMarkedInRange (s, cardEnd, objectEnd)) {
+      foreachObjptrInObject (s, advanceToObjectData (s, objectStart),
+                             forwardObjptrIfInNurseryParallel, FALSE);
+      w->bytesScanned += (uintmax_t)(objectEnd - objectStart);
+    }
+    objectStart = objectEnd;
+  }
+  /* An object starting at stripeEnd is owned by this stripe. */
+  if (objectStart == stripeEnd and stripeEnd < oldGenEnd) {
+    objectEnd = objectStart + sizeofObject (s, advanceToObjectData (s, objectStart));
+    if (isCardMarkedInRange (s, objectStart, objectEnd)) {
+      foreachObjptrInObject (s, advanceToObjectData (s, objectStart),
+                             forwardObjptrIfInNurseryParallel, FALSE);
+      w->bytesScanned += (uintmax_t)(objectEnd - objectStart);
+    }
+  }
+}
@@ -17,6 +17,8 @@ struct GC_forwardState {
 };
 
 #define GC_FORWARDED ~((GC_header)0)
+/* Marks an object that a GC thread is copying; see forwardObjptrParallel. */
+#define GC_FORWARDING ~((GC_header)1)
 
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
 
@@ -27,8 +29,19 @@ static inline bool isPointerInToSpace (GC_state s, pointer p);
 static inline bool isObjptrInToSpace (GC_state s, objptr op);
 #endif
 
+static inline size_t sizeofObjectForForward (GC_state s, pointer p, GC_header header,
+                                             size_t *headerBytesp, size_t *skipp);
+static inline void linkWeakForForward (GC_state s, pointer newp, GC_header header,
+                                       GC_weak *weaksp);
 static inline void forwardObjptr (GC_state s, objptr *opp);
+static void forwardObjptrParallel (GC_state s, objptr *opp);
 static inline void forwardObjptrIfInNursery (GC_state s, objptr *opp);
-static inline void forwardInterGenerationalObjptrs (GC_state s);
+static inline void forwardInterGenerationalObjptrs (GC_state s, GC_foreachObjptrFun f);
+static inline void forwardObjptrIfInNurseryParallel (GC_state s, objptr *opp);
+static bool isCardMarkedInRange (GC_state s, pointer front, pointer back);
+static pointer findStripeStart (GC_state s, size_t stripe);
+static void findStripeStartsJob (GC_state s);
+static void forwardInterGenerationalObjptrsInStripe (GC_state s, pointer objectStart,
+                                                     pointer stripeEnd);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
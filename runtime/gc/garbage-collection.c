@@ -13,20 +13,28 @@ void minorGC (GC_state s) {
 
 void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
   uintmax_t numGCs;
-  size_t desiredSize;
+  size_t desiredSize, heapSize;
+  pointer heapStart;
 
+  releaseSurvivorSpaces (s);
   s->lastMajorStatistics.numMinorGCs = 0;
+  forgetNurserySurvival (s);
+  clearHoles (s);
   numGCs = 
     s->cumulativeStatistics.numCopyingGCs 
     + s->cumulativeStatistics.numMarkCompactGCs;
   if (0 < numGCs
       and ((float)(s->cumulativeStatistics.numHashConsGCs) / (float)(numGCs)
-           < s->controls.ratios.hashCons))
+           < s->controls.ratios.hashCons)
+      and not isConcurrentMarkActive (s)) // the mark is already underway
     s->hashConsDuringGC = TRUE;
   desiredSize = 
     sizeofHeapDesired (s, s->lastMajorStatistics.bytesLive + bytesRequested, 0);
   if (not FORCE_MARK_COMPACT
       and not s->hashConsDuringGC // only markCompact can hash cons
+      and not s->markCompactDuringGC // nor keep the heap in place
+      and not isConcurrentMarkActive (s) // nor use a concurrent mark
+      and not s->controls.markRegion // nor keep dense blocks in place
       and s->heap.withMapsSize < s->sysvals.ram
       and (not isHeapInit (&s->secondaryHeap)
            or createHeapSecondary (s, desiredSize)))
@@ -34,6 +42,9 @@ void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
   else
     majorMarkCompactGC (s);
   s->hashConsDuringGC = FALSE;
+  s->markCompactDuringGC = FALSE;
+  sweepLargeObjects (s);
+  takeHeapCensus (s);
   s->lastMajorStatistics.bytesLive = s->heap.oldGenSize;
   if (s->lastMajorStatistics.bytesLive > s->cumulativeStatistics.maxBytesLive)
     s->cumulativeStatistics.maxBytesLive = s->lastMajorStatistics.bytesLive;
@@ -42,10 +53,20 @@ void majorGC (GC_state s, size_t bytesRequested, bool mayResize) {
    * argument to createHeapSecondary above.  Above, it was an
    * estimate.  Here, it is exactly how much was live after the GC.
    */
+  heapStart = s->heap.start;
+  heapSize = s->heap.size;
   if (mayResize) {
     resizeHeap (s, s->lastMajorStatistics.bytesLive + bytesRequested);
   }
-  setCardMapAndCrossMap (s);
+  if (GC_MARK_COMPACT == s->lastMajorStatistics.kind
+      and heapStart == s->heap.start
+      and heapSize == s->heap.size) {
+    /* The compaction rebuilt the crossMap in place. */
+    assert (s->generationalMaps.crossMapValidSize == s->heap.oldGenSize);
+    if (s->mutatorMarksCards)
+      clearCardMap (s);
+  } else
+    setCardMapAndCrossMap (s);
   resizeHeapSecondary (s);
   assert (s->heap.oldGenSize + bytesRequested <= s->heap.size);
 }
@@ -96,13 +117,20 @@ void performGC (GC_state s,
                 bool forceMajor,
                 bool mayResize) {
   uintmax_t gcTime;
+  GC_pauseKind pauseKind;
+  uintmax_t pauseStart;
+  uintmax_t pauseTime;
   bool stackTopOk;
   size_t stackBytesRequested;
   struct rusage ru_start;
   size_t totalBytesRequested;
 
   enterGC (s);
+  pauseStart = GC_getMonotonicTime ();
+  pauseKind = GC_PAUSE_MINOR;
   s->cumulativeStatistics.numGCs++;
+  beginEventLog (s);
+  beginStatsSegment (s);
   if (DEBUG or s->controls.messages) {
     size_t nurserySize = s->heap.size - ((size_t)(s->heap.nursery - s->heap.start));
     size_t nurseryUsed = (size_t)(s->frontier - s->heap.nursery);
@@ -139,13 +167,37 @@ void performGC (GC_state s,
     stackTopOk 
     ? 0 
     : sizeofStackWithHeader (s, sizeofStackGrowReserved (s, getStackCurrent (s)));
+  /* The survivors must fit in the old generation if minor GCs stop. */
   totalBytesRequested = 
     oldGenBytesRequested 
     + nurseryBytesRequested
-    + stackBytesRequested;
+    + stackBytesRequested
+    + sizeofSurvivors (s);
+  if (isIncrementalMarkPending (s)
+      and totalBytesRequested <= s->heap.size - s->heap.oldGenSize)
+    markIncrementalSlice (s, pauseStart, TRUE);
+  if (not forceMajor
+      and totalBytesRequested <= s->heap.size - s->heap.oldGenSize
+      and isConcurrentMarkDone (s)
+      and finishConcurrentMark (s)) {
+    if (isConcurrentCompactWorthwhile (s))
+      forceMajor = TRUE;
+    else {
+      sweepLargeObjects (s);
+      endConcurrentMark (s);
+      setConcurrentMarkTrigger (s);
+    }
+  }
   if (forceMajor 
-      or totalBytesRequested > s->heap.size - s->heap.oldGenSize)
+      or totalBytesRequested > s->heap.size - s->heap.oldGenSize) {
     majorGC (s, totalBytesRequested, mayResize);
+    pauseKind =
+      (GC_COPYING == s->lastMajorStatistics.kind)
+      ? GC_PAUSE_COPYING
+      : GC_PAUSE_MARK_COMPACT;
+    setConcurrentMarkTrigger (s);
+  } else if (shouldStartConcurrentMark (s))
+    startConcurrentMark (s);
   setGCStateCurrentHeap (s, oldGenBytesRequested + stackBytesRequested, 
                          nurseryBytesRequested);
   assert (hasHeapBytesFree (s, oldGenBytesRequested + stackBytesRequested,
@@ -159,6 +211,10 @@ void performGC (GC_state s,
       max (s->cumulativeStatistics.maxPauseTime, gcTime);
   } else
     gcTime = 0;  /* Assign gcTime to quell gcc warning. */
+  pauseTime = GC_getMonotonicTime () - pauseStart;
+  recordPause (s, pauseKind, pauseTime);
+  endEventLog (s, pauseTime);
+  updateStatsSegment (s, pauseTime);
   if (DEBUG or s->controls.messages) {
     size_t nurserySize = s->heap.size - (size_t)(s->heap.nursery - s->heap.start);
     fprintf (stderr, 
@@ -195,13 +251,46 @@ void performGC (GC_state s,
   leaveGC (s);
 }
 
+/* Take a slice of an incremental mark between GCs, when the mutator
+ * traps at the lowered limit or allocates a large array.  The slice
+ * pauses the mutator as a minor GC does, and is counted as a minor
+ * pause.
+ */
+void performMarkSlice (GC_state s) {
+  uintmax_t gcTime;
+  uintmax_t pauseStart;
+  uintmax_t pauseTime;
+  struct rusage ru_start;
+
+  enterGC (s);
+  pauseStart = GC_getMonotonicTime ();
+  beginEventLog (s);
+  beginStatsSegment (s);
+  if (needGCTime (s))
+    startTiming (&ru_start);
+  markIncrementalSlice (s, pauseStart, FALSE);
+  if (needGCTime (s)) {
+    gcTime = stopTiming (&ru_start, &s->cumulativeStatistics.ru_gc);
+    s->cumulativeStatistics.maxPauseTime = 
+      max (s->cumulativeStatistics.maxPauseTime, gcTime);
+  }
+  pauseTime = GC_getMonotonicTime () - pauseStart;
+  recordPause (s, GC_PAUSE_MINOR, pauseTime);
+  endEventLog (s, pauseTime);
+  updateStatsSegment (s, pauseTime);
+  leaveGC (s);
+}
+
 void ensureInvariantForMutator (GC_state s, bool force) {
   if (force
       or not (invariantForMutatorFrontier(s))
       or not (invariantForMutatorStack(s))) {
     /* This GC will grow the stack, if necessary. */
     performGC (s, 0, getThreadCurrent(s)->bytesNeeded, force, TRUE);
-  }
+  } else if (isSafepointRequested (s))
+    serveSafepoint (s);
+  else if (isIncrementalMarkPending (s))
+    performMarkSlice (s);
   assert (invariantForMutatorFrontier(s));
   assert (invariantForMutatorStack(s));
 }
@@ -19,6 +19,7 @@ static void performGC (GC_state s,
                        size_t nurseryBytesRequested, 
                        bool forceMajor,
                        bool mayResize);
+static void performMarkSlice (GC_state s);
 static inline void ensureInvariantForMutator (GC_state s, bool force);
 static inline void ensureHasHeapBytesFree (GC_state s, 
                                            size_t oldGenBytesRequested,
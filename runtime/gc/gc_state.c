@@ -54,6 +54,7 @@ void setGCStateCurrentHeap (GC_state s,
   size_t nurserySize;
   pointer genNursery;
   size_t genNurserySize;
+  size_t survivorReserve;
 
   if (DEBUG_DETAILED)
     fprintf (stderr, "setGCStateCurrentHeap(%s, %s)\n",
@@ -61,12 +62,15 @@ void setGCStateCurrentHeap (GC_state s,
              uintmaxToCommaString(nurseryBytesRequested));
   h = &s->heap;
   assert (isFrontierAligned (s, h->start + h->oldGenSize + oldGenBytesRequested));
-  s->limitPlusSlop = h->start + h->size;
+  survivorReserve = reserveSurvivorSpaces (s, oldGenBytesRequested);
+  s->limitPlusSlop = h->start + h->size - survivorReserve;
   s->limit = s->limitPlusSlop - GC_HEAP_LIMIT_SLOP;
-  nurserySize = h->size - (h->oldGenSize + oldGenBytesRequested);
+  nurserySize = h->size - survivorReserve - (h->oldGenSize + oldGenBytesRequested);
   assert (isFrontierAligned (s, s->limitPlusSlop - nurserySize));
   nursery = s->limitPlusSlop - nurserySize;
-  genNursery = alignFrontier (s, s->limitPlusSlop - (nurserySize / 2));
+  /* The survivors may be promoted along with the nursery. */
+  genNursery = alignFrontier (s, s->limitPlusSlop
+                                 - ((nurserySize - sizeofSurvivors (s)) / 2));
   genNurserySize = (size_t)(s->limitPlusSlop - genNursery);
   if (/* The mutator marks cards. */
       s->mutatorMarksCards
@@ -87,12 +91,30 @@ void setGCStateCurrentHeap (GC_state s,
            <= (h->withMapsSize < s->sysvals.ram
                ? s->controls.ratios.copyGenerational
                : s->controls.ratios.markCompactGenerational))
-       )) {
+       )
+      and /* Enough of the nursery dies to be worth it. */
+      (not useAdaptiveNursery (s) or isMinorGCWorthwhile (s))) {
     s->canMinor = TRUE;
+    if (useAdaptiveNursery (s)) {
+      size_t size;
+
+      size = sizeofNurseryAdaptive (s, genNurserySize, nurseryBytesRequested);
+      if (size < genNurserySize) {
+        genNursery = alignFrontier (s, s->limitPlusSlop - size);
+        genNurserySize = (size_t)(s->limitPlusSlop - genNursery);
+      }
+    }
     nursery = genNursery;
     nurserySize = genNurserySize;
     clearCardMap (s);
   } else {
+    if (survivorReserve > 0) {
+      releaseSurvivorSpaces (s);
+      s->limitPlusSlop = h->start + h->size;
+      s->limit = s->limitPlusSlop - GC_HEAP_LIMIT_SLOP;
+      nurserySize = h->size - (h->oldGenSize + oldGenBytesRequested);
+      nursery = s->limitPlusSlop - nurserySize;
+    }
     unless (nurseryBytesRequested <= nurserySize)
       die ("Out of memory.  Insufficient space in nursery.");
     s->canMinor = FALSE;
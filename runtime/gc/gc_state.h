@@ -20,7 +20,9 @@ struct GC_state {
   pointer stackLimit; /* stackBottom + stackSize - maxFrameSize */
   size_t exnStack;
   /* Alphabetized fields follow. */
+  struct GC_adaptiveNursery adaptiveNursery;
   size_t alignment; /* */
+  struct GC_allocSampler allocSampler;
   bool amInGC;
   bool amOriginal;
   char **atMLtons; /* Initial @MLton args, processed before command line. */
@@ -29,9 +31,11 @@ struct GC_state {
   objptr callFromCHandlerThread; /* Handler for exported C calls (in heap). */
   struct GC_callStackState callStackState;
   bool canMinor; /* TRUE iff there is space for a minor gc. */
+  struct GC_concurrentMark concurrentMark;
   struct GC_controls controls;
   struct GC_cumulativeStatistics cumulativeStatistics;
   objptr currentThread; /* Currently executing thread (in heap). */
+  struct GC_eventLog eventLog;
   struct GC_forwardState forwardState;
   GC_frameLayout frameLayouts; /* Array of frame layouts. */
   uint32_t frameLayoutsLength; /* Cardinality of frameLayouts array. */
@@ -40,17 +44,26 @@ struct GC_state {
   uint32_t globalsLength;
   bool hashConsDuringGC;
   struct GC_heap heap;
+  struct GC_heapCensus heapCensus;
+  struct GC_heapDump heapDump;
+  struct GC_largeObjectSpace largeObjects;
   struct GC_lastMajorStatistics lastMajorStatistics;
+  struct GC_lastWorld lastWorld;
   pointer limitPlusSlop; /* limit + GC_HEAP_LIMIT_SLOP */
   int (*loadGlobals)(FILE *f); /* loads the globals from the file. */
   uint32_t magic; /* The magic number for this executable. */
+  struct GC_mappedWorld mappedWorld;
+  bool markCompactDuringGC; /* Keep the heap in place; see saveWorldToFILE. */
+  struct GC_markRegion markRegion;
   uint32_t maxFrameSize;
   bool mutatorMarksCards;
   GC_objectHashTable objectHashTable;
   GC_objectType objectTypes; /* Array of object types. */
   uint32_t objectTypesLength; /* Cardinality of objectTypes array. */
+  struct GC_parallelState parallelState;
   struct GC_profiling profiling;
   GC_frameIndex (*returnAddressToFrameIndex) (GC_returnAddress ra);
+  uint32_t safepointRequests; /* See safepoint.h. */
   objptr savedThread; /* Result of GC_copyCurrentThread.
                        * Thread interrupted by arrival of signal.
                        */
@@ -61,11 +74,14 @@ struct GC_state {
   struct GC_signalsInfo signalsInfo;
   struct GC_sourceMaps sourceMaps;
   pointer stackBottom; /* Bottom of stack in current thread. */
+  struct GC_statsSegment statsSegment;
+  struct GC_survivorSpaces survivorSpaces;
   struct GC_sysvals sysvals;
   struct GC_translateState translateState;
   struct GC_vectorInit *vectorInits;
   uint32_t vectorInitsLength;
   GC_weak weaks; /* Linked list of (live) weak pointers */
+  struct GC_worker *worker; /* Non-NULL iff in a GC thread; see parallel.h. */
 };
 
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
@@ -168,8 +168,13 @@ GC_crossMapIndex lenofCrossMap (ARG_USED_FOR_ASSERT GC_state s, size_t crossMapS
 void clearCardMap (GC_state s) {
   if (DEBUG_GENERATIONAL and DEBUG_DETAILED)
     fprintf (stderr, "clearCardMap ()\n");
-  memset (s->generationalMaps.cardMap, 0,
-          s->generationalMaps.cardMapLength * CARD_MAP_ELEM_SIZE);
+  if (isConcurrentMarkActive (s))
+    mergeCardMapForConcurrentMark (s);
+  if (sizeofSurvivors (s) > 0)
+    keepSurvivorCards (s);
+  else
+    memset (s->generationalMaps.cardMap, 0,
+            s->generationalMaps.cardMapLength * CARD_MAP_ELEM_SIZE);
 }
 
 void clearCrossMap (GC_state s) {
@@ -383,7 +388,7 @@ loopObjects:
     goto loopObjects;
   assert (objectStart == oldGenEnd);
   s->generationalMaps.crossMap[cardIndex] =
-    (GC_crossMapElem)(oldGenEnd - cardStart) / CROSS_MAP_OFFSET_SCALE;
+    (GC_crossMapElem)((oldGenEnd - cardStart) / CROSS_MAP_OFFSET_SCALE);
   s->generationalMaps.crossMapValidSize = s->heap.oldGenSize;
 done:
   assert (s->generationalMaps.crossMapValidSize == s->heap.oldGenSize);
@@ -393,3 +398,66 @@ done:
     displayGenerationalMaps (s, &s->generationalMaps, stderr);
   }
 }
+
+/* A compaction rebuilds the crossMap as it places the objects of the
+ * old generation, rather than leaving the next minor GC to walk the
+ * whole old generation in updateCrossMap.  The GC threads of a
+ * parallel compaction may record boundaries in the same card, so
+ * recordCrossMapBoundary keeps the largest offset atomically.
+ */
+void startCrossMapRebuild (GC_state s) {
+  if (s->mutatorMarksCards)
+    clearCrossMap (s);
+}
+
+void recordCrossMapBoundary (GC_state s, pointer p) {
+  GC_cardMapIndex cardIndex;
+  GC_crossMapElem *elem, offset, old;
+
+  unless (s->mutatorMarksCards)
+    return;
+  cardIndex =
+    (p == s->heap.start)
+    ? 0
+    : sizeToCardMapIndex ((size_t)(p - s->heap.start) - 1);
+  offset =
+    (GC_crossMapElem)((size_t)(p - (s->heap.start + cardMapIndexToSize (cardIndex)))
+                      / CROSS_MAP_OFFSET_SCALE);
+  assert (offset < CROSS_MAP_EMPTY);
+  elem = &s->generationalMaps.crossMap[cardIndex];
+  old = __atomic_load_n (elem, __ATOMIC_RELAXED);
+  while ((CROSS_MAP_EMPTY == old or old < offset)
+         and not __atomic_compare_exchange_n (elem, &old, offset, TRUE,
+                                              __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED))
+    ;
+}
+
+void finishCrossMapRebuild (GC_state s) {
+  unless (s->mutatorMarksCards)
+    return;
+  if (s->heap.oldGenSize > 0)
+    recordCrossMapBoundary (s, s->heap.start + s->heap.oldGenSize);
+  s->generationalMaps.crossMapValidSize = s->heap.oldGenSize;
+  assert (isCrossMapOk (s));
+}
+
+/* addCrossMapBoundary (s, p)
+ *
+ * Record in a valid crossMap the object boundary p, which splits an
+ * object below the end of the old generation in two.
+ */
+void addCrossMapBoundary (GC_state s, pointer p) {
+  GC_cardMapIndex cardIndex;
+  GC_crossMapElem *crossMap;
+  size_t offset;
+
+  assert (s->heap.start < p and p < s->heap.start + s->generationalMaps.crossMapValidSize);
+  crossMap = s->generationalMaps.crossMap;
+  cardIndex = sizeToCardMapIndex ((size_t)(p - s->heap.start) - 1);
+  offset = (size_t)(p - (s->heap.start + cardMapIndexToSize (cardIndex)))
+           / CROSS_MAP_OFFSET_SCALE;
+  assert (offset < CROSS_MAP_EMPTY);
+  if (CROSS_MAP_EMPTY == crossMap[cardIndex] or crossMap[cardIndex] < offset)
+    crossMap[cardIndex] = (GC_crossMapElem)offset;
+}
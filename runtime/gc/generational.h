@@ -95,5 +95,9 @@ static void setCardMapAndCrossMap (GC_state s);
 static bool isCrossMapOk (GC_state s);
 #endif
 static void updateCrossMap (GC_state s);
+static void addCrossMapBoundary (GC_state s, pointer p);
+static inline void startCrossMapRebuild (GC_state s);
+static inline void recordCrossMapBoundary (GC_state s, pointer p);
+static void finishCrossMapRebuild (GC_state s);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
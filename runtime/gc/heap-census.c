@@ -0,0 +1,185 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initHeapCensus (GC_state s) {
+  s->heapCensus.entries = NULL;
+  s->heapCensus.f = NULL;
+  if (0 == s->controls.heapCensus)
+    return;
+  s->heapCensus.entries =
+    (struct GC_heapCensusEntry*)(calloc_safe (s->objectTypesLength,
+                                              sizeof (struct GC_heapCensusEntry)));
+  s->heapCensus.f = fopen_safe (s->controls.heapCensusFile, "w");
+  resetHeapCensus (s);
+}
+
+bool useHeapCensus (GC_state s) {
+  return NULL != s->heapCensus.f;
+}
+
+void resetHeapCensus (GC_state s) {
+  struct GC_heapCensusEntry *entries;
+
+  entries = s->heapCensus.entries;
+  for (uint32_t i = 0; i < s->objectTypesLength; i++) {
+    entries[i].bytes = 0;
+    entries[i].count = 0;
+    entries[i].objectTypeIndex = i;
+  }
+  s->heapCensus.fillerBytes = 0;
+  s->heapCensus.fillerCount = 0;
+  s->heapCensus.oldGenCounted = FALSE;
+}
+
+void countObjectForHeapCensus (GC_state s, pointer p, size_t size) {
+  struct GC_heapCensusEntry *e;
+
+  e = &s->heapCensus.entries[(getHeader (p) & TYPE_INDEX_MASK) >> TYPE_INDEX_SHIFT];
+  e->bytes += size;
+  e->count++;
+}
+
+/* Count the objects in [front, back), which must all be live or
+ * fillers that are counted by countFillersForHeapCensus.
+ */
+void countRangeForHeapCensus (GC_state s, pointer front, pointer back) {
+  while (front < back) {
+    pointer p;
+    size_t size;
+
+    p = advanceToObjectData (s, front);
+    size = sizeofObject (s, p);
+    countObjectForHeapCensus (s, p, size);
+    front += size;
+  }
+  assert (front == back);
+}
+
+void countFillersForHeapCensus (GC_state s, uintmax_t bytes, uintmax_t count) {
+  unless (useHeapCensus (s))
+    return;
+  s->heapCensus.fillerBytes += bytes;
+  s->heapCensus.fillerCount += count;
+}
+
+/* The types that the runtime builds headers for; see object.h.  The
+ * rest are only known by their layout.
+ */
+const char *objectTypeIndexToString (uint32_t objectTypeIndex) {
+  switch (objectTypeIndex) {
+  case STACK_TYPE_INDEX:
+    return "stack";
+  case THREAD_TYPE_INDEX:
+    return "thread";
+  case WEAK_GONE_TYPE_INDEX:
+    return "weak gone";
+  case WORD8_VECTOR_TYPE_INDEX:
+    return "word8 vector";
+  case WORD32_VECTOR_TYPE_INDEX:
+    return "word32 vector";
+  case WORD16_VECTOR_TYPE_INDEX:
+    return "word16 vector";
+  case WORD64_VECTOR_TYPE_INDEX:
+    return "word64 vector";
+  default:
+    return "-";
+  }
+}
+
+int compareHeapCensusEntries (const void *v1, const void *v2) {
+  const struct GC_heapCensusEntry* e1 = (const struct GC_heapCensusEntry*)v1;
+  const struct GC_heapCensusEntry* e2 = (const struct GC_heapCensusEntry*)v2;
+
+  if (e1->bytes > e2->bytes)
+    return -1;
+  else if (e1->bytes < e2->bytes)
+    return 1;
+  else if (e1->objectTypeIndex < e2->objectTypeIndex)
+    return -1;
+  else if (e1->objectTypeIndex > e2->objectTypeIndex)
+    return 1;
+  else
+    return 0;
+}
+
+/* takeHeapCensus (s)
+ *
+ * counts the live objects of the old generation, unless the GC has
+ * already, and the large objects, which hold only live objects at the
+ * end of a major GC, and appends a table of the heap-census types
+ * with the most bytes to heap-census-file.
+ */
+void takeHeapCensus (GC_state s) {
+  struct GC_heapCensusEntry *entries;
+  uint32_t i, n;
+  struct GC_largeObject *lo;
+  uintmax_t restBytes, restCount, totalBytes, totalCount;
+
+  unless (useHeapCensus (s))
+    return;
+  entries = s->heapCensus.entries;
+  unless (s->heapCensus.oldGenCounted)
+    countRangeForHeapCensus (s, alignFrontier (s, s->heap.start),
+                             s->heap.start + s->heap.oldGenSize);
+  assert (entries[WORD8_VECTOR_TYPE_INDEX].bytes >= s->heapCensus.fillerBytes);
+  assert (entries[WORD8_VECTOR_TYPE_INDEX].count >= s->heapCensus.fillerCount);
+  entries[WORD8_VECTOR_TYPE_INDEX].bytes -= s->heapCensus.fillerBytes;
+  entries[WORD8_VECTOR_TYPE_INDEX].count -= s->heapCensus.fillerCount;
+  for (lo = s->largeObjects.objects; lo != NULL; lo = lo->next) {
+    pointer p;
+
+    p = getLargeObjectArray (s, lo);
+    countObjectForHeapCensus (s, p, sizeofObject (s, p));
+  }
+  totalBytes = 0;
+  totalCount = 0;
+  for (i = 0; i < s->objectTypesLength; i++) {
+    totalBytes += entries[i].bytes;
+    totalCount += entries[i].count;
+  }
+  qsort (entries, s->objectTypesLength, sizeof (*entries),
+         compareHeapCensusEntries);
+  fprintf (s->heapCensus.f,
+           "# gc %"PRIuMAX", %s: %"PRIuMAX" objects, %"PRIuMAX" bytes\n",
+           s->cumulativeStatistics.numGCs,
+           (GC_COPYING == s->lastMajorStatistics.kind) ? "copying" : "mark-compact",
+           totalCount, totalBytes);
+  fprintf (s->heapCensus.f,
+           "# bytes\tobjects\t%% bytes\ttype\ttag\tbytesNonObjptrs\tnumObjptrs\tname\n");
+  n = min (s->controls.heapCensus, s->objectTypesLength);
+  restBytes = totalBytes;
+  restCount = totalCount;
+  for (i = 0; i < n and entries[i].count > 0; i++) {
+    GC_objectType t;
+
+    t = &s->objectTypes[entries[i].objectTypeIndex];
+    fprintf (s->heapCensus.f,
+             "%"PRIuMAX"\t%"PRIuMAX"\t%.1f\t%"PRIu32"\t%s\t%"PRIu16"\t%"PRIu16"\t%s\n",
+             entries[i].bytes, entries[i].count,
+             100.0 * (double)entries[i].bytes / (double)totalBytes,
+             entries[i].objectTypeIndex, objectTypeTagToString (t->tag),
+             t->bytesNonObjptrs, t->numObjptrs,
+             objectTypeIndexToString (entries[i].objectTypeIndex));
+    restBytes -= entries[i].bytes;
+    restCount -= entries[i].count;
+  }
+  if (restCount > 0)
+    fprintf (s->heapCensus.f,
+             "# others: %"PRIuMAX" objects, %"PRIuMAX" bytes\n",
+             restCount, restBytes);
+  fprintf (s->heapCensus.f, "\n");
+  fflush (s->heapCensus.f);
+  resetHeapCensus (s);
+}
+
+void closeHeapCensus (GC_state s) {
+  unless (useHeapCensus (s))
+    return;
+  fclose_safe (s->heapCensus.f);
+  s->heapCensus.f = NULL;
+  free (s->heapCensus.entries);
+  s->heapCensus.entries = NULL;
+}
@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With heap-census, each major GC ends by counting the objects and
+ * bytes of each type index among the live objects of the old
+ * generation and the large objects.  The heap-census types with the
+ * most bytes are appended to heap-census-file.
+ *
+ * A compacting or copying GC leaves only live objects in the old
+ * generation, which the census walks, except for the tails of the
+ * buffers of the parallel copy, which are filled with Word8 vectors.
+ * Those fillers are counted as the GC leaves them, and taken back out
+ * of the Word8 vectors.  Mark-region keeps dense regions in place,
+ * with dead objects and fillers between the live ones, so it counts
+ * the live objects of those regions by their start bits, before the
+ * mark maps are freed.
+ */
+struct GC_heapCensusEntry {
+  uintmax_t bytes;
+  uintmax_t count;
+  uint32_t objectTypeIndex;
+};
+
+struct GC_heapCensus {
+  struct GC_heapCensusEntry *entries; /* Indexed by type index. */
+  FILE *f; /* NULL unless heap-census. */
+  uintmax_t fillerBytes; /* Fillers left in the old generation by this GC. */
+  uintmax_t fillerCount;
+  bool oldGenCounted; /* The GC has counted the old generation itself. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initHeapCensus (GC_state s);
+static inline bool useHeapCensus (GC_state s);
+static void resetHeapCensus (GC_state s);
+static inline void countObjectForHeapCensus (GC_state s, pointer p, size_t size);
+static void countRangeForHeapCensus (GC_state s, pointer front, pointer back);
+static void countFillersForHeapCensus (GC_state s, uintmax_t bytes, uintmax_t count);
+static const char *objectTypeIndexToString (uint32_t objectTypeIndex);
+static int compareHeapCensusEntries (const void *v1, const void *v2);
+static void takeHeapCensus (GC_state s);
+static void closeHeapCensus (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
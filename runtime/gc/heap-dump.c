@@ -0,0 +1,189 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+static GC_state heapDumpState;
+
+void initHeapDump (GC_state s) {
+  struct sigaction sa;
+
+  s->heapDump.f = NULL;
+  s->heapDump.numEdges = 0;
+  s->heapDump.object = NULL;
+  if (0 == s->controls.heapDumpSignal)
+    return;
+  heapDumpState = s;
+  memset (&sa, 0, sizeof(sa));
+  sigfillset (&sa.sa_mask);
+#if HAS_SIGALTSTACK
+  sa.sa_flags = SA_ONSTACK;
+#endif
+  sa.sa_handler = handleHeapDumpSignal;
+  unless (sigaction (s->controls.heapDumpSignal, &sa, NULL) == 0)
+    diee ("initHeapDump: sigaction failed");
+}
+
+void writeHeapDumpNumber (FILE *f, uintmax_t n) {
+  unsigned char buf[(CHAR_BIT * sizeof(uintmax_t) + 6) / 7];
+  size_t i;
+
+  i = 0;
+  while (n >= 0x80) {
+    buf[i++] = (unsigned char)(0x80 | (n & 0x7F));
+    n >>= 7;
+  }
+  buf[i++] = (unsigned char)n;
+  fwrite (buf, 1, i, f);
+}
+
+void writeHeapDumpOffset (FILE *f, uintptr_t a, uintptr_t base) {
+  if (a >= base)
+    writeHeapDumpNumber (f, 2 * (uintmax_t)(a - base));
+  else
+    writeHeapDumpNumber (f, 2 * (uintmax_t)(base - a) - 1);
+}
+
+void writeHeapDumpRoot (GC_state s, objptr *opp) {
+  pointer p;
+  GC_heapDumpRoot root;
+  uintmax_t index;
+
+  index = 0;
+  if (s->globals <= opp and opp < s->globals + s->globalsLength) {
+    root = GC_HEAP_DUMP_ROOT_GLOBAL;
+    index = (uintmax_t)(opp - s->globals);
+  } else if (opp == &s->callFromCHandlerThread)
+    root = GC_HEAP_DUMP_ROOT_CALL_FROM_C_HANDLER_THREAD;
+  else if (opp == &s->currentThread)
+    root = GC_HEAP_DUMP_ROOT_CURRENT_THREAD;
+  else if (opp == &s->savedThread)
+    root = GC_HEAP_DUMP_ROOT_SAVED_THREAD;
+  else {
+    assert (opp == &s->signalHandlerThread);
+    root = GC_HEAP_DUMP_ROOT_SIGNAL_HANDLER_THREAD;
+  }
+  writeHeapDumpNumber (s->heapDump.f, GC_HEAP_DUMP_ROOT);
+  writeHeapDumpNumber (s->heapDump.f, root);
+  writeHeapDumpNumber (s->heapDump.f, index);
+  p = objptrToPointer (*opp, s->heap.start);
+  writeHeapDumpNumber (s->heapDump.f, (uintmax_t)(uintptr_t)p);
+}
+
+void countHeapDumpEdge (GC_state s, __attribute__ ((unused)) objptr *opp) {
+  s->heapDump.numEdges++;
+}
+
+void writeHeapDumpEdge (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  writeHeapDumpOffset (s->heapDump.f, (uintptr_t)p, (uintptr_t)s->heapDump.object);
+}
+
+/* writeHeapDumpObject (s, p, size, prevp)
+ *
+ * writes the record of the object p, of size bytes, whose address is
+ * relative to *prevp, and sets *prevp to p.  The objptrs are walked
+ * twice, to write their number first.
+ */
+void writeHeapDumpObject (GC_state s, pointer p, size_t size, uintptr_t *prevp) {
+  FILE *f;
+
+  f = s->heapDump.f;
+  s->heapDump.numEdges = 0;
+  s->heapDump.object = p;
+  foreachObjptrInObject (s, p, countHeapDumpEdge, TRUE);
+  writeHeapDumpNumber (f, GC_HEAP_DUMP_OBJECT);
+  writeHeapDumpOffset (f, (uintptr_t)p, *prevp);
+  writeHeapDumpNumber (f, (getHeader (p) & TYPE_INDEX_MASK) >> TYPE_INDEX_SHIFT);
+  writeHeapDumpNumber (f, size);
+  writeHeapDumpNumber (f, s->heapDump.numEdges);
+  foreachObjptrInObject (s, p, writeHeapDumpEdge, TRUE);
+  *prevp = (uintptr_t)p;
+}
+
+/* dumpHeap (s, fileName)
+ *
+ * writes the heap to fileName, and returns whether it could.  It must
+ * follow a major GC, which leaves the objects in the old generation
+ * and the large objects.
+ */
+bool dumpHeap (GC_state s, const char *fileName) {
+  pointer back, front;
+  FILE *f;
+  uint32_t i;
+  struct GC_largeObject *lo;
+  uintptr_t prev;
+  bool res;
+
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr, "[GC: Dumping heap to %s.]\n", fileName);
+  f = fopen (fileName, "wb");
+  if (NULL == f)
+    return FALSE;
+  s->heapDump.f = f;
+  fputs (GC_HEAP_DUMP_MAGIC, f);
+  writeHeapDumpNumber (f, GC_HEAP_DUMP_VERSION);
+  writeHeapDumpNumber (f, s->objectTypesLength);
+  for (i = 0; i < s->objectTypesLength; i++) {
+    GC_objectType t;
+
+    t = &s->objectTypes[i];
+    writeHeapDumpNumber (f, t->tag);
+    writeHeapDumpNumber (f, t->hasIdentity);
+    writeHeapDumpNumber (f, t->bytesNonObjptrs);
+    writeHeapDumpNumber (f, t->numObjptrs);
+  }
+  foreachGlobalObjptr (s, writeHeapDumpRoot);
+  prev = 0;
+  front = alignFrontier (s, s->heap.start);
+  back = s->heap.start + s->heap.oldGenSize;
+  while (front < back) {
+    pointer p;
+    size_t size;
+
+    p = advanceToObjectData (s, front);
+    size = sizeofObject (s, p);
+    writeHeapDumpObject (s, p, size, &prev);
+    front += size;
+  }
+  assert (front == back);
+  for (lo = s->largeObjects.objects; lo != NULL; lo = lo->next) {
+    pointer p;
+
+    p = getLargeObjectArray (s, lo);
+    writeHeapDumpObject (s, p, sizeofObject (s, p), &prev);
+  }
+  writeHeapDumpNumber (f, GC_HEAP_DUMP_END);
+  s->heapDump.f = NULL;
+  res = not ferror (f);
+  if (0 != fclose (f))
+    res = FALSE;
+  return res;
+}
+
+void dumpHeapAtSafepoint (GC_state s) {
+  performGC (s, 0, getThreadCurrent(s)->bytesNeeded, TRUE, TRUE);
+  unless (dumpHeap (s, s->controls.heapDumpFile))
+    fprintf (stderr, "[GC: Could not dump heap to %s: %s.]\n",
+             s->controls.heapDumpFile, strerror (errno));
+}
+
+/* handleHeapDumpSignal only requests a safepoint, at which the
+ * mutator dumps the heap.
+ */
+void handleHeapDumpSignal (__attribute__ ((unused)) int signum) {
+  requestSafepoint (heapDumpState, GC_SAFEPOINT_HEAP_DUMP);
+}
+
+C_Errno_t(Bool_t) GC_dumpHeap (GC_state s, NullString8_t fileName) {
+  bool res;
+
+  enter (s);
+  performGC (s, 0, 0, TRUE, TRUE);
+  res = dumpHeap (s, (const char*)fileName);
+  leave (s);
+  return (Bool_t)res;
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A heap dump is written by GC_dumpHeap, or at the safepoint that
+ * heap-dump-signal requests, just after a major GC, so that it holds
+ * the live objects of the old generation and the large objects, and
+ * whatever dead space the collector left in place.  mlheap reads it.
+ *
+ * All numbers are unsigned LEB128: seven bits a byte, least
+ * significant first, with the high bit set on all but the last byte.
+ * The dump is
+ *
+ *   GC_HEAP_DUMP_MAGIC, GC_HEAP_DUMP_VERSION
+ *   the number of object types, then, for each type, its tag,
+ *     hasIdentity, bytesNonObjptrs and numObjptrs
+ *   records, each starting with a GC_heapDumpRecord, up to the
+ *     GC_HEAP_DUMP_END one
+ *
+ * A GC_HEAP_DUMP_ROOT record gives a GC_heapDumpRoot, the index of
+ * the global for GC_HEAP_DUMP_ROOT_GLOBAL and 0 otherwise, and the
+ * address of the object.  A GC_HEAP_DUMP_OBJECT record gives the
+ * address of the object, relative to that of the previous object
+ * record, or to 0 for the first, its type index, its size in bytes,
+ * with its header, and the number of its objptrs, followed by the
+ * address of the object that each points to, relative to its own.
+ * The relative addresses are signed, zig-zag encoded: 2n for n >= 0,
+ * and -2n - 1 for n < 0.  An address is that of the object data, just
+ * after the header.  The objptrs of a weak object are not written,
+ * since they do not keep objects live; those of a stack are the live
+ * slots of its frames.
+ */
+#define GC_HEAP_DUMP_MAGIC "MLton heap dump\n"
+#define GC_HEAP_DUMP_VERSION 1
+
+typedef enum {
+  GC_HEAP_DUMP_END = 0,
+  GC_HEAP_DUMP_ROOT = 1,
+  GC_HEAP_DUMP_OBJECT = 2,
+} GC_heapDumpRecord;
+
+typedef enum {
+  GC_HEAP_DUMP_ROOT_GLOBAL = 0,
+  GC_HEAP_DUMP_ROOT_CALL_FROM_C_HANDLER_THREAD = 1,
+  GC_HEAP_DUMP_ROOT_CURRENT_THREAD = 2,
+  GC_HEAP_DUMP_ROOT_SAVED_THREAD = 3,
+  GC_HEAP_DUMP_ROOT_SIGNAL_HANDLER_THREAD = 4,
+} GC_heapDumpRoot;
+
+struct GC_heapDump {
+  FILE *f; /* NULL unless a dump is being written. */
+  uintmax_t numEdges; /* Of the object being written. */
+  pointer object; /* Being written. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initHeapDump (GC_state s);
+static inline void writeHeapDumpNumber (FILE *f, uintmax_t n);
+static inline void writeHeapDumpOffset (FILE *f, uintptr_t a, uintptr_t base);
+static void writeHeapDumpRoot (GC_state s, objptr *opp);
+static void countHeapDumpEdge (GC_state s, objptr *opp);
+static void writeHeapDumpEdge (GC_state s, objptr *opp);
+static void writeHeapDumpObject (GC_state s, pointer p, size_t size, uintptr_t *prevp);
+static bool dumpHeap (GC_state s, const char *fileName);
+static void dumpHeapAtSafepoint (GC_state s);
+static void handleHeapDumpSignal (int signum);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
+#if (defined (MLTON_GC_INTERNAL_BASIS))
+
+/* TRUE = success, FALSE = failure */
+PRIVATE C_Errno_t(Bool_t) GC_dumpHeap (GC_state s, NullString8_t fileName);
+
+#endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
@@ -10,13 +10,19 @@ void displayHeap (__attribute__ ((unused)) GC_state s,
                   GC_heap heap,
                   FILE *stream) {
   fprintf(stream,
+          "\t\texplicitHugePages = %s\n"
           "\t\tnursery = "FMTPTR"\n"
           "\t\toldGenSize = %"PRIuMAX"\n"
+          "\t\treserved = %s\n"
+          "\t\treservedSize = %"PRIuMAX"\n"
           "\t\tsize = %"PRIuMAX"\n"
           "\t\tstart = "FMTPTR"\n"
           "\t\twithMapsSize = %"PRIuMAX"\n",
+          boolToString (heap->explicitHugePages),
           (uintptr_t)heap->nursery,
           (uintmax_t)heap->oldGenSize,
+          boolToString (heap->reserved),
+          (uintmax_t)heap->reservedSize,
           (uintmax_t)heap->size,
           (uintptr_t)heap->start,
           (uintmax_t)heap->withMapsSize);
@@ -25,8 +31,11 @@ void displayHeap (__attribute__ ((unused)) GC_state s,
 
 void initHeap (__attribute__ ((unused)) GC_state s,
                GC_heap h) {
+  h->explicitHugePages = FALSE;
   h->nursery = NULL;
   h->oldGenSize = 0;
+  h->reserved = FALSE;
+  h->reservedSize = 0;
   h->size = 0;
   h->start = NULL;
   h->withMapsSize = 0;
@@ -145,6 +154,148 @@ size_t sizeofHeapDesired (GC_state s, size_t liveSize, size_t currentSize) {
   return resSize;
 }
 
+/* Display what the kernel reports for the pages of the heap. */
+void displayHeapPages (GC_state s, GC_heap h, FILE *stream) {
+  if (NULL == h->start
+      or (GC_HUGE_PAGES_NONE == s->controls.hugePages
+          and GC_NUMA_POLICY_DEFAULT == s->controls.numaPolicy))
+    return;
+  fprintf (stream, "pages of heap at "FMTPTR":\n", (uintptr_t)(h->start));
+  GC_displayMemPages (stream, h->start);
+}
+
+/* The bytes mapped for a heap with its card/cross maps, which are
+ * whole huge pages with explicit huge pages.
+ */
+size_t sizeofHeapMapping (GC_state s, GC_heap h, size_t withMapsSize) {
+  if (h->explicitHugePages)
+    return align (withMapsSize, s->sysvals.hugePageSize);
+  return withMapsSize;
+}
+
+/* The bytes that reserve-heap reserves for each heap: as many as
+ * fixed-heap or max-heap allow, or else four times the physical
+ * memory, but at most half of the address space.
+ */
+size_t sizeofHeapReservation (GC_state s) {
+  uintmax_t size;
+
+  if (s->controls.fixedHeap > 0)
+    size = s->controls.fixedHeap;
+  else if (s->controls.maxHeap > 0)
+    size = s->controls.maxHeap;
+  else
+    size = 4 * s->sysvals.physMem;
+  if (size > SIZE_MAX / 2)
+    size = SIZE_MAX / 2;
+  return align ((size_t)size, s->sysvals.pageSize);
+}
+
+/* mapHeapAligned (s, address, length, alignment, reserve)
+ *
+ * Maps, or only reserves, length bytes near address, starting on a
+ * multiple of alignment, or returns (void*)-1.  The mapping is made
+ * alignment bytes larger and trimmed.
+ */
+pointer mapHeapAligned (GC_state s, pointer address, size_t length,
+                        size_t alignment, bool reserve) {
+  pointer base, start, end;
+  size_t extra;
+
+  extra = alignment - s->sysvals.pageSize;
+  if (length > SIZE_MAX - extra)
+    return (pointer)-1;
+  base = reserve
+    ? GC_reserve (address, length + extra)
+    : GC_mmapAnon (address, length + extra);
+  if ((void*)-1 == base)
+    return base;
+  start = base + (align ((size_t)base, alignment) - (size_t)base);
+  end = base + length + extra;
+  if (base < start)
+    GC_release (base, (size_t)(start - base));
+  if (start + length < end)
+    GC_release (start + length, (size_t)(end - (start + length)));
+  return start;
+}
+
+/* mapHeap (s, h, address, withMapsSize)
+ *
+ * Maps withMapsSize bytes for h, near address, with the pages that
+ * huge-pages and numa-policy ask for, or returns (void*)-1.  Explicit
+ * huge pages, which must have been reserved by the administrator,
+ * fall back to transparent ones.  Transparent huge pages are only
+ * used in the huge-page-aligned part of a mapping, so the mapping
+ * starts on a huge page.  With reserve-heap, the rest of the
+ * reservation follows the withMapsSize bytes, and explicit huge pages
+ * are not used, since they cannot be committed later.  Sets
+ * h->reservedSize.
+ */
+pointer mapHeap (GC_state s, GC_heap h, pointer address, size_t withMapsSize) {
+  size_t alignment, hugePageSize;
+  pointer start;
+
+  hugePageSize = s->sysvals.hugePageSize;
+  h->explicitHugePages = FALSE;
+  h->reserved = FALSE;
+  start = (pointer)-1;
+  if (GC_HUGE_PAGES_EXPLICIT == s->controls.hugePages and hugePageSize > 0
+      and not s->controls.reserveHeap) {
+    start = GC_mmapAnonHuge (address, align (withMapsSize, hugePageSize));
+    if ((void*)-1 != start) {
+      h->explicitHugePages = TRUE;
+      h->reservedSize = align (withMapsSize, hugePageSize);
+    } else if (s->controls.messages)
+      fprintf (stderr,
+               "[GC: Unable to map %s bytes of explicit huge pages; using transparent huge pages.]\n",
+               uintmaxToCommaString(align (withMapsSize, hugePageSize)));
+  }
+  alignment =
+    (GC_HUGE_PAGES_NONE != s->controls.hugePages and hugePageSize > 0)
+    ? hugePageSize : s->sysvals.pageSize;
+  if ((void*)-1 == start and s->controls.reserveHeap) {
+    size_t reservedSize;
+
+    reservedSize = max (withMapsSize, sizeofHeapReservation (s));
+    start = mapHeapAligned (s, address, reservedSize, alignment, TRUE);
+    if ((void*)-1 != start) {
+      if (GC_commit (start, withMapsSize)) {
+        h->reserved = TRUE;
+        h->reservedSize = reservedSize;
+      } else {
+        GC_release (start, reservedSize);
+        start = (pointer)-1;
+      }
+    }
+    if ((void*)-1 == start and s->controls.messages)
+      fprintf (stderr,
+               "[GC: Unable to reserve %s bytes for heap; mapping it as usual.]\n",
+               uintmaxToCommaString(reservedSize));
+  }
+  if ((void*)-1 == start) {
+    start = mapHeapAligned (s, address, withMapsSize, alignment, FALSE);
+    if ((void*)-1 == start)
+      return start;
+    h->reservedSize = withMapsSize;
+  }
+  if (alignment > s->sysvals.pageSize and not h->explicitHugePages)
+    unless (GC_adviseHugePages (start, h->reservedSize))
+      if (s->controls.messages)
+        fprintf (stderr,
+                 "[GC: Unable to advise transparent huge pages for heap at "FMTPTR".]\n",
+                 (uintptr_t)start);
+  unless (GC_NUMA_POLICY_DEFAULT == s->controls.numaPolicy
+          or GC_setNumaPolicy (start, h->reservedSize,
+                               GC_NUMA_POLICY_INTERLEAVE == s->controls.numaPolicy))
+    if (s->controls.messages)
+      fprintf (stderr,
+               "[GC: Unable to set NUMA policy %s for heap at "FMTPTR".]\n",
+               (GC_NUMA_POLICY_INTERLEAVE == s->controls.numaPolicy)
+               ? "interleave" : "local",
+               (uintptr_t)start);
+  return start;
+}
+
 void releaseHeap (GC_state s, GC_heap h) {
   if (NULL == h->start)
     return;
@@ -154,10 +305,39 @@ void releaseHeap (GC_state s, GC_heap h) {
              (uintptr_t)(h->start),
              uintmaxToCommaString(h->size),
              uintmaxToCommaString(h->withMapsSize - h->size));
-  GC_release (h->start, h->withMapsSize);
+  GC_release (h->start, h->reservedSize);
   initHeap (s, h);
 }
 
+/* discardHeap (s, h, keepWithMapsSize)
+ *
+ * gives the pages of h after its first keepWithMapsSize bytes back to
+ * the OS, for heap-release free or dontneed.
+ */
+void discardHeap (GC_state s, GC_heap h, size_t keepWithMapsSize) {
+  pointer start, end;
+
+  if (NULL == h->start)
+    return;
+  start = h->start + keepWithMapsSize;
+  end = h->start + h->withMapsSize;
+  if (h->explicitHugePages) {
+    /* Only whole huge pages can be given back. */
+    start = h->start + align (keepWithMapsSize, s->sysvals.hugePageSize);
+    end = h->start + sizeofHeapMapping (s, h, h->withMapsSize);
+  }
+  if (end <= start)
+    return;
+  if (GC_discard (start, (size_t)(end - start),
+                  GC_HEAP_RELEASE_FREE == s->controls.heapRelease))
+    s->cumulativeStatistics.bytesDiscarded += (size_t)(end - start);
+  else if (s->controls.messages)
+    fprintf (stderr,
+             "[GC: Unable to discard %s bytes of heap at "FMTPTR".]\n",
+             uintmaxToCommaString((size_t)(end - start)),
+             (uintptr_t)(h->start));
+}
+
 /* shrinkHeap (s, h, keepSize)
  */
 void shrinkHeap (GC_state s, GC_heap h, size_t keepSize) {
@@ -183,12 +363,46 @@ void shrinkHeap (GC_state s, GC_heap h, size_t keepSize) {
     }
     assert (isAligned (keepWithMapsSize, s->sysvals.pageSize));
     assert (keepWithMapsSize <= h->withMapsSize);
-    GC_release (h->start + keepWithMapsSize, h->withMapsSize - keepWithMapsSize);
+    if (h->reserved) {
+      discardHeap (s, h, keepWithMapsSize);
+      GC_decommit (h->start + keepWithMapsSize,
+                   h->withMapsSize - keepWithMapsSize);
+    } else if (GC_HEAP_RELEASE_UNMAP != s->controls.heapRelease) {
+      discardHeap (s, h, keepWithMapsSize);
+    } else if (sizeofHeapMapping (s, h, keepWithMapsSize) < h->reservedSize) {
+      GC_release (h->start + sizeofHeapMapping (s, h, keepWithMapsSize),
+                  h->reservedSize - sizeofHeapMapping (s, h, keepWithMapsSize));
+      h->reservedSize = sizeofHeapMapping (s, h, keepWithMapsSize);
+    }
     h->size = keepSize;
     h->withMapsSize = keepWithMapsSize;
   }
 }
 
+/* initHeapMapping (s, h, start, size)
+ *
+ * makes h the heap of size bytes mapped by mapHeap at start.
+ */
+void initHeapMapping (GC_state s, GC_heap h, pointer start, size_t size) {
+  h->start = start;
+  h->size = size;
+  h->withMapsSize = size + sizeofCardMapAndCrossMap (s, size);
+  if (h->size > s->cumulativeStatistics.maxHeapSize)
+    s->cumulativeStatistics.maxHeapSize = h->size;
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr,
+             "[GC: Created heap at "FMTPTR" of size %s bytes (+ %s bytes card/cross map).]\n",
+             (uintptr_t)(h->start),
+             uintmaxToCommaString(h->size),
+             uintmaxToCommaString(h->withMapsSize - h->size));
+  if ((DEBUG or s->controls.messages) and h->reserved)
+    fprintf (stderr,
+             "[GC:\twithin %s bytes reserved.]\n",
+             uintmaxToCommaString(h->reservedSize));
+  if (DEBUG or s->controls.messages)
+    displayHeapPages (s, h, stderr);
+}
+
 /* createHeap (s, h, desiredSize, minSize)
  *
  * allocates a heap of the size necessary to work with desiredSize
@@ -248,21 +462,11 @@ bool createHeap (GC_state s, GC_heap h,
       if (i == addressCount)
         address = 0;
 
-      newStart = GC_mmapAnon ((pointer)address, newWithMapsSize);
+      newStart = mapHeap (s, h, (pointer)address, newWithMapsSize);
       unless ((void*)-1 == newStart) {
         addressScanDir = not addressScanDir;
-        h->start = newStart;
-        h->size = newSize;
-        h->withMapsSize = newWithMapsSize;
-        if (h->size > s->cumulativeStatistics.maxHeapSize)
-          s->cumulativeStatistics.maxHeapSize = h->size;
+        initHeapMapping (s, h, newStart, newSize);
         assert (minSize <= h->size and h->size <= desiredSize);
-        if (DEBUG or s->controls.messages)
-          fprintf (stderr,
-                   "[GC: Created heap at "FMTPTR" of size %s bytes (+ %s bytes card/cross map).]\n",
-                   (uintptr_t)(h->start),
-                   uintmaxToCommaString(h->size),
-                   uintmaxToCommaString(h->withMapsSize - h->size));
         return TRUE;
       }
     }
@@ -288,6 +492,41 @@ bool createHeap (GC_state s, GC_heap h,
   return FALSE;
 }
 
+/* createHeapAt (s, h, address, desiredSize, minSize)
+ *
+ * is like createHeap, but only allocates a heap that starts at
+ * address, and tries only desiredSize and minSize.  The address is
+ * passed to mapHeap as a hint, which the OS need not follow.
+ */
+bool createHeapAt (GC_state s, GC_heap h, pointer address,
+                   size_t desiredSize, size_t minSize) {
+  size_t newSize;
+
+  if (desiredSize < minSize)
+    desiredSize = minSize;
+  minSize = align (minSize, s->sysvals.pageSize);
+  desiredSize = align (desiredSize, s->sysvals.pageSize);
+  assert (isHeapInit (h) and NULL == h->start);
+  unless (isAligned ((size_t)address, s->sysvals.pageSize))
+    return FALSE;
+  newSize = desiredSize;
+  while (TRUE) {
+    pointer newStart;
+
+    newStart = mapHeap (s, h, address,
+                        newSize + sizeofCardMapAndCrossMap (s, newSize));
+    if (address == newStart) {
+      initHeapMapping (s, h, newStart, newSize);
+      return TRUE;
+    }
+    unless ((void*)-1 == newStart)
+      GC_release (newStart, h->reservedSize);
+    if (newSize == minSize)
+      return FALSE;
+    newSize = minSize;
+  }
+}
+
 /* createHeapSecondary (s, desiredSize)
  */
 bool createHeapSecondary (GC_state s, size_t desiredSize) {
@@ -306,6 +545,52 @@ bool createHeapSecondary (GC_state s, size_t desiredSize) {
   return createHeap (s, &s->secondaryHeap, desiredSize, s->heap.oldGenSize);
 }
 
+/* regrowHeap (s, h, desiredSize, minSize)
+ *
+ * grows h, up to desiredSize, into the pages that it reserves, either
+ * after shrinking with heap-release free or dontneed, or with
+ * reserve-heap, where they are committed.  It returns FALSE, and
+ * leaves h alone, unless h grows to at least minSize.
+ */
+bool regrowHeap (GC_state s, GC_heap h,
+                 size_t desiredSize,
+                 size_t minSize) {
+  size_t newSize, newWithMapsSize;
+
+  assert (isAligned (desiredSize, s->sysvals.pageSize));
+
+  if (h->reservedSize <= h->withMapsSize)
+    return FALSE;
+  newSize = invertSizeofCardMapAndCrossMap (s, h->reservedSize);
+  if (newSize > desiredSize)
+    newSize = desiredSize;
+  if (newSize <= h->size or newSize < minSize)
+    return FALSE;
+  newWithMapsSize = newSize + sizeofCardMapAndCrossMap (s, newSize);
+  if (h->reserved
+      and not GC_commit (h->start + h->withMapsSize,
+                         newWithMapsSize - h->withMapsSize))
+    return FALSE;
+  if (DEBUG or s->controls.messages) {
+    fprintf (stderr,
+             "[GC: Regrowing heap at "FMTPTR" of size %s bytes (+ %s bytes card/cross map)]\n",
+             (uintptr_t)(h->start),
+             uintmaxToCommaString(h->size),
+             uintmaxToCommaString(h->withMapsSize - h->size));
+    fprintf (stderr,
+             "[GC:\tto size %s bytes (+ %s bytes card/cross map) within %s bytes reserved.]\n",
+             uintmaxToCommaString(newSize),
+             uintmaxToCommaString(sizeofCardMapAndCrossMap (s, newSize)),
+             uintmaxToCommaString(h->reservedSize));
+  }
+  h->size = newSize;
+  h->withMapsSize = newWithMapsSize;
+  assert (h->withMapsSize <= h->reservedSize);
+  if (h->size > s->cumulativeStatistics.maxHeapSize)
+    s->cumulativeStatistics.maxHeapSize = h->size;
+  return TRUE;
+}
+
 /* remapHeap (s, h, desiredSize, minSize)
  */
 #if not HAS_REMAP
@@ -330,8 +615,21 @@ bool remapHeap (GC_state s, GC_heap h,
              uintmaxToCommaString(minSize));
   assert (minSize <= desiredSize);
   assert (desiredSize >= h->size);
+  /* Explicit huge pages and reservations are not remapped. */
+  if (h->explicitHugePages or h->reserved)
+    return FALSE;
   minSize = align (minSize, s->sysvals.pageSize);
   desiredSize = align (desiredSize, s->sysvals.pageSize);
+  /* Sizes that fit in the reservation need no mremap; see regrowHeap. */
+  if (h->reservedSize > h->withMapsSize) {
+    size_t reservedHeapSize;
+
+    reservedHeapSize = invertSizeofCardMapAndCrossMap (s, h->reservedSize);
+    if (minSize <= reservedHeapSize)
+      minSize = reservedHeapSize + s->sysvals.pageSize;
+    if (desiredSize < minSize)
+      return FALSE;
+  }
 
   /* Biased binary search (between minSize and desiredSize) for a
    * successful mremap.
@@ -348,7 +646,7 @@ bool remapHeap (GC_state s, GC_heap h,
 
     assert (isAligned (newWithMapsSize, s->sysvals.pageSize));
 
-    newStart = GC_mremap (h->start, h->withMapsSize, newWithMapsSize);
+    newStart = GC_mremap (h->start, h->reservedSize, newWithMapsSize);
     if ((void*)-1 != newStart) {
       pointer origStart = h->start;
       size_t origSize = h->size;
@@ -356,6 +654,7 @@ bool remapHeap (GC_state s, GC_heap h,
       h->start = newStart;
       h->size = newSize;
       h->withMapsSize = newWithMapsSize;
+      h->reservedSize = newWithMapsSize;
       if (h->size > s->cumulativeStatistics.maxHeapSize)
         s->cumulativeStatistics.maxHeapSize = h->size;
       assert (minSize <= h->size and h->size <= desiredSize);
@@ -451,7 +750,9 @@ void growHeap (GC_state s, size_t desiredSize, size_t minSize) {
   origStart = curHeapp->start;
   liveSize = curHeapp->oldGenSize;
   assert (liveSize <= curHeapp->size);
-  if (remapHeap (s, curHeapp, desiredSize, minSize)) {
+  if (regrowHeap (s, curHeapp, desiredSize, desiredSize)
+      or remapHeap (s, curHeapp, desiredSize, minSize)
+      or regrowHeap (s, curHeapp, desiredSize, minSize)) {
     goto done;
   }
   if (!useCurrent)
@@ -573,10 +874,17 @@ void resizeHeapSecondary (GC_state s) {
     /* Holding on to secondaryHeap might cause paging.  So don't. */
     releaseHeap (s, &s->secondaryHeap);
   else if (secondarySize < primarySize) {
-    unless (remapHeap (s, &s->secondaryHeap, primarySize, primarySize))
+    unless (regrowHeap (s, &s->secondaryHeap, primarySize, primarySize)
+            or remapHeap (s, &s->secondaryHeap, primarySize, primarySize))
       releaseHeap (s, &s->secondaryHeap);
   } else if (secondarySize > primarySize)
     shrinkHeap (s, &s->secondaryHeap, primarySize);
   assert (0 == s->secondaryHeap.size
           or s->heap.size == s->secondaryHeap.size);
+  /* After a copying GC, the secondary heap is the old from-space, which
+   * is idle until the next copying GC.
+   */
+  if (GC_HEAP_RELEASE_UNMAP != s->controls.heapRelease
+      and GC_COPYING == s->lastMajorStatistics.kind)
+    discardHeap (s, &s->secondaryHeap, 0);
 }
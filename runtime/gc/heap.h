@@ -21,11 +21,20 @@
  *  ^                                      ^
  *  start                                  nursery
  *  |------------------------------withMapsSize-----------------------------|
+ *
+ * With heap-release free or dontneed, a heap that shrinks keeps its
+ * pages mapped but gives them back to the OS, and it grows back into
+ * them; reservedSize is the number of bytes mapped at start.  With
+ * reserve-heap, the bytes after withMapsSize are reserved, but not
+ * committed, and the heap grows into them without moving.
 */
 
 typedef struct GC_heap {
+  bool explicitHugePages; /* mapped with MAP_HUGETLB; see mapHeap */
   pointer nursery; /* start of nursery */
   size_t oldGenSize; /* size of old generation */
+  bool reserved; /* committed only up to withMapsSize; see mapHeap */
+  size_t reservedSize; /* bytes mapped at start, at least withMapsSize */
   size_t size; /* size of heap */
   pointer start; /* start of heap (and old generation) */
   size_t withMapsSize; /* size of heap with card/cross maps */
@@ -54,10 +63,21 @@ static void displayHeap (GC_state s, GC_heap heap, FILE *stream);
 static inline void initHeap (GC_state s, GC_heap h);
 static inline size_t sizeofHeapDesired (GC_state s, size_t live, size_t currentSize);
 
+static void displayHeapPages (GC_state s, GC_heap h, FILE *stream);
+static inline size_t sizeofHeapMapping (GC_state s, GC_heap h, size_t withMapsSize);
+static size_t sizeofHeapReservation (GC_state s);
+static pointer mapHeapAligned (GC_state s, pointer address, size_t length,
+                               size_t alignment, bool reserve);
+static pointer mapHeap (GC_state s, GC_heap h, pointer address, size_t withMapsSize);
+static void initHeapMapping (GC_state s, GC_heap h, pointer start, size_t size);
 static inline void releaseHeap (GC_state s, GC_heap h);
+static void discardHeap (GC_state s, GC_heap h, size_t keepWithMapsSize);
 static void shrinkHeap (GC_state s, GC_heap h, size_t keepSize);
 static bool createHeap (GC_state s, GC_heap h, size_t desiredSize, size_t minSize);
+static bool createHeapAt (GC_state s, GC_heap h, pointer address,
+                          size_t desiredSize, size_t minSize);
 static bool createHeapSecondary (GC_state s, size_t desiredSize);
+static bool regrowHeap (GC_state s, GC_heap h, size_t desiredSize, size_t minSize);
 static bool remapHeap (GC_state s, GC_heap h, size_t desiredSize, size_t minSize);
 static void growHeap (GC_state s, size_t desiredSize, size_t minSize);
 static void resizeHeap (GC_state s, size_t minSize);
@@ -12,9 +12,13 @@ bool isPointerInOldGen (GC_state s, pointer p) {
               and p < s->heap.start + s->heap.oldGenSize));
 }
 
+/* Survivors are as young as the objects in the nursery; see
+ * survivor.h.
+ */
 bool isPointerInNursery (GC_state s, pointer p) {
   return (not (isPointer (p))
-          or (s->heap.nursery <= p and p < s->frontier));
+          or (s->heap.nursery <= p and p < s->frontier)
+          or isPointerInSurvivorSpace (s, p));
 }
 
 #if ASSERT
@@ -38,7 +42,8 @@ bool isObjptrInNursery (GC_state s, objptr op) {
 #if ASSERT
 bool isObjptrInFromSpace (GC_state s, objptr op) {
   return (isObjptrInOldGen (s, op) 
-          or isObjptrInNursery (s, op));
+          or isObjptrInNursery (s, op)
+          or isPointerToLargeObject (s, objptrToPointer (op, s->heap.start)));
 }
 #endif
 
@@ -48,7 +53,8 @@ bool hasHeapBytesFree (GC_state s, size_t oldGen, size_t nursery) {
 
   total =
     s->heap.oldGenSize + oldGen 
-    + (s->canMinor ? 2 : 1) * (size_t)(s->limitPlusSlop - s->heap.nursery);
+    + (s->canMinor ? 2 : 1) * (size_t)(s->limitPlusSlop - s->heap.nursery)
+    + sizeofSurvivorReserve (s);
   res = 
     (total <= s->heap.size) 
     and (nursery <= (size_t)(s->limitPlusSlop - s->frontier));
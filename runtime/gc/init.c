@@ -19,6 +19,44 @@ static bool stringToBool (char *s) {
   die ("Invalid @MLton bool: %s.", s);
 }
 
+static GC_heapRelease stringToHeapRelease (char *s) {
+  if (0 == strcmp (s, "unmap"))
+    return GC_HEAP_RELEASE_UNMAP;
+  if (0 == strcmp (s, "free"))
+    return GC_HEAP_RELEASE_FREE;
+  if (0 == strcmp (s, "dontneed"))
+    return GC_HEAP_RELEASE_DONTNEED;
+  die ("Invalid @MLton heap release: %s.", s);
+}
+
+static GC_hugePages stringToHugePages (char *s) {
+  if (0 == strcmp (s, "none"))
+    return GC_HUGE_PAGES_NONE;
+  if (0 == strcmp (s, "transparent"))
+    return GC_HUGE_PAGES_TRANSPARENT;
+  if (0 == strcmp (s, "explicit"))
+    return GC_HUGE_PAGES_EXPLICIT;
+  die ("Invalid @MLton huge pages: %s.", s);
+}
+
+static GC_numaPolicy stringToNumaPolicy (char *s) {
+  if (0 == strcmp (s, "default"))
+    return GC_NUMA_POLICY_DEFAULT;
+  if (0 == strcmp (s, "interleave"))
+    return GC_NUMA_POLICY_INTERLEAVE;
+  if (0 == strcmp (s, "local"))
+    return GC_NUMA_POLICY_LOCAL;
+  die ("Invalid @MLton NUMA policy: %s.", s);
+}
+
+static GC_profileFormat stringToProfileFormat (char *s) {
+  if (0 == strcmp (s, "mlmon"))
+    return GC_PROFILE_FORMAT_MLMON;
+  if (0 == strcmp (s, "collapsed"))
+    return GC_PROFILE_FORMAT_COLLAPSED;
+  die ("Invalid @MLton profile format: %s.", s);
+}
+
 // From gdtoa/gdtoa.h.
 // Can't include the whole thing because it brings in too much junk.
 float gdtoa__strtof (const char *, char **);
@@ -67,6 +105,69 @@ bad:
   die ("Invalid @MLton memory amount: %s.", s);
 }
 
+static uint32_t stringToThreads (char *s) {
+  unsigned long n;
+  char *endptr;
+
+  n = strtoul (s, &endptr, 10);
+  unless (s != endptr
+          and *endptr == '\0'
+          and 1 <= n
+          and n <= 1024)
+    die ("Invalid @MLton number of threads: %s.", s);
+  return (uint32_t)n;
+}
+
+static uint32_t stringToHeapCensus (char *s) {
+  unsigned long n;
+  char *endptr;
+
+  n = strtoul (s, &endptr, 10);
+  unless (s != endptr
+          and *endptr == '\0'
+          and n <= UINT32_MAX)
+    die ("Invalid @MLton heap census: %s.", s);
+  return (uint32_t)n;
+}
+
+static int stringToSignal (char *s) {
+  unsigned long n;
+  char *endptr;
+
+  n = strtoul (s, &endptr, 10);
+  unless (s != endptr
+          and *endptr == '\0'
+          and 1 <= n
+          and n <= INT_MAX)
+    die ("Invalid @MLton signal: %s.", s);
+  return (int)n;
+}
+
+static uint32_t stringToTenuringThreshold (char *s) {
+  unsigned long n;
+  char *endptr;
+
+  n = strtoul (s, &endptr, 10);
+  unless (s != endptr
+          and *endptr == '\0'
+          and n <= UINT8_MAX)
+    die ("Invalid @MLton tenuring threshold: %s.", s);
+  return (uint32_t)n;
+}
+
+static uintmax_t stringToMilliseconds (char *s) {
+  unsigned long long n;
+  char *endptr;
+
+  n = strtoull (s, &endptr, 10);
+  unless (s != endptr
+          and *endptr == '\0'
+          and 1 <= n
+          and n <= 1000000)
+    die ("Invalid @MLton number of milliseconds: %s.", s);
+  return (uintmax_t)n;
+}
+
 /* ---------------------------------------------------------------- */
 /*                             GC_init                              */
 /* ---------------------------------------------------------------- */
@@ -90,7 +191,32 @@ int processAtMLton (GC_state s, int argc, char **argv,
         char *arg;
 
         arg = argv[i];
-        if (0 == strcmp (arg, "copy-generational-ratio")) {
+        if (0 == strcmp (arg, "adaptive-nursery")) {
+          i++;
+          if (i == argc)
+            die ("@MLton adaptive-nursery missing argument.");
+          s->controls.adaptiveNursery = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "alloc-sample-bytes")) {
+          i++;
+          if (i == argc)
+            die ("@MLton alloc-sample-bytes missing argument.");
+          s->controls.allocSampleBytes = stringToBytes (argv[i++]);
+        } else if (0 == strcmp (arg, "alloc-sample-file")) {
+          i++;
+          if (i == argc)
+            die ("@MLton alloc-sample-file missing argument.");
+          s->controls.allocSampleFile = argv[i++];
+        } else if (0 == strcmp (arg, "compress-world")) {
+          i++;
+          if (i == argc)
+            die ("@MLton compress-world missing argument.");
+          s->controls.compressWorld = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "concurrent-mark")) {
+          i++;
+          if (i == argc)
+            die ("@MLton concurrent-mark missing argument.");
+          s->controls.concurrentMark = stringToBool (argv[i++]);
+        } else if (0 == strcmp (arg, "copy-generational-ratio")) {
           i++;
           if (i == argc)
             die ("@MLton copy-generational-ratio missing argument.");
@@ -104,18 +230,33 @@ int processAtMLton (GC_state s, int argc, char **argv,
           s->controls.ratios.copy = stringToFloat (argv[i++]);
           unless (1.0 < s->controls.ratios.copy)
             die ("@MLton copy-ratio argument must be greater than 1.0.");
+        } else if (0 == strcmp (arg, "delta-world")) {
+          i++;
+          if (i == argc)
+            die ("@MLton delta-world missing argument.");
+          s->controls.deltaWorld = stringToBool (argv[i++]);
         } else if (0 == strcmp (arg, "fixed-heap")) {
           i++;
           if (i == argc)
             die ("@MLton fixed-heap missing argument.");
           s->controls.fixedHeap = align (stringToBytes (argv[i++]),
                                          2 * s->sysvals.pageSize);
+        } else if (0 == strcmp (arg, "gc-log")) {
+          i++;
+          if (i == argc)
+            die ("@MLton gc-log missing argument.");
+          s->controls.gcLog = argv[i++];
         } else if (0 == strcmp (arg, "gc-messages")) {
           i++;
           s->controls.messages = TRUE;
         } else if (0 == strcmp (arg, "gc-summary")) {
           i++;
           s->controls.summary = TRUE;
+        } else if (0 == strcmp (arg, "gc-threads")) {
+          i++;
+          if (i == argc)
+            die ("@MLton gc-threads missing argument.");
+          s->controls.gcThreads = stringToThreads (argv[i++]);
         } else if (0 == strcmp (arg, "grow-ratio")) {
           i++;
           if (i == argc)
@@ -131,6 +272,41 @@ int processAtMLton (GC_state s, int argc, char **argv,
           unless (0.0 <= s->controls.ratios.hashCons
                   and s->controls.ratios.hashCons <= 1.0)
             die ("@MLton hash-cons argument must be between 0.0 and 1.0.");
+        } else if (0 == strcmp (arg, "heap-census")) {
+          i++;
+          if (i == argc)
+            die ("@MLton heap-census missing argument.");
+          s->controls.heapCensus = stringToHeapCensus (argv[i++]);
+        } else if (0 == strcmp (arg, "heap-census-file")) {
+          i++;
+          if (i == argc)
+            die ("@MLton heap-census-file missing argument.");
+          s->controls.heapCensusFile = argv[i++];
+        } else if (0 == strcmp (arg, "heap-dump-file")) {
+          i++;
+          if (i == argc)
+            die ("@MLton heap-dump-file missing argument.");
+          s->controls.heapDumpFile = argv[i++];
+        } else if (0 == strcmp (arg, "heap-dump-signal")) {
+          i++;
+          if (i == argc)
+            die ("@MLton heap-dump-signal missing argument.");
+          s->controls.heapDumpSignal = stringToSignal (argv[i++]);
+        } else if (0 == strcmp (arg, "heap-release")) {
+          i++;
+          if (i == argc)
+            die ("@MLton heap-release missing argument.");
+          s->controls.heapRelease = stringToHeapRelease (argv[i++]);
+        } else if (0 == strcmp (arg, "huge-pages")) {
+          i++;
+          if (i == argc)
+            die ("@MLton huge-pages missing argument.");
+          s->controls.hugePages = stringToHugePages (argv[i++]);
+        } else if (0 == strcmp (arg, "large-object-size")) {
+          i++;
+          if (i == argc)
+            die ("@MLton large-object-size missing argument.");
+          s->controls.largeObjectSize = stringToBytes (argv[i++]);
         } else if (0 == strcmp (arg, "live-ratio")) {
           i++;
           if (i == argc)
@@ -146,6 +322,11 @@ int processAtMLton (GC_state s, int argc, char **argv,
           if (i == argc)
             die ("@MLton load-world missing argument.");
           *worldFile = argv[i++];
+        } else if (0 == strcmp (arg, "map-world")) {
+          i++;
+          if (i == argc)
+            die ("@MLton map-world missing argument.");
+          s->controls.mapWorld = stringToBool (argv[i++]);
         } else if (0 == strcmp (arg, "mark-compact-generational-ratio")) {
           i++;
           if (i == argc)
@@ -160,12 +341,27 @@ int processAtMLton (GC_state s, int argc, char **argv,
           s->controls.ratios.markCompact = stringToFloat (argv[i++]);
           unless (1.0 < s->controls.ratios.markCompact)
             die ("@MLton mark-compact-ratio argument must be greater than 1.0.");
+        } else if (0 == strcmp (arg, "mark-region")) {
+          i++;
+          if (i == argc)
+            die ("@MLton mark-region missing argument.");
+          s->controls.markRegion = stringToBool (argv[i++]);
         } else if (0 == strcmp (arg, "max-heap")) {
           i++;
           if (i == argc)
             die ("@MLton max-heap missing argument.");
           s->controls.maxHeap = align (stringToBytes (argv[i++]),
                                        2 * s->sysvals.pageSize);
+        } else if (0 == strcmp (arg, "max-minor-pause-ms")) {
+          i++;
+          if (i == argc)
+            die ("@MLton max-minor-pause-ms missing argument.");
+          s->controls.maxMinorPause = stringToMilliseconds (argv[i++]);
+        } else if (0 == strcmp (arg, "max-pause-ms")) {
+          i++;
+          if (i == argc)
+            die ("@MLton max-pause-ms missing argument.");
+          s->controls.maxPause = stringToMilliseconds (argv[i++]);
         } else if (0 == strcmp (arg, "may-page-heap")) {
           i++;
           if (i == argc)
@@ -174,6 +370,11 @@ int processAtMLton (GC_state s, int argc, char **argv,
         } else if (0 == strcmp (arg, "no-load-world")) {
           i++;
           s->controls.mayLoadWorld = FALSE;
+        } else if (0 == strcmp (arg, "numa-policy")) {
+          i++;
+          if (i == argc)
+            die ("@MLton numa-policy missing argument.");
+          s->controls.numaPolicy = stringToNumaPolicy (argv[i++]);
         } else if (0 == strcmp (arg, "nursery-ratio")) {
           i++;
           if (i == argc)
@@ -181,11 +382,21 @@ int processAtMLton (GC_state s, int argc, char **argv,
           s->controls.ratios.nursery = stringToFloat (argv[i++]);
           unless (1.0 < s->controls.ratios.nursery)
             die ("@MLton nursery-ratio argument must be greater than 1.0.");
+        } else if (0 == strcmp (arg, "profile-format")) {
+          i++;
+          if (i == argc)
+            die ("@MLton profile-format missing argument.");
+          s->controls.profileFormat = stringToProfileFormat (argv[i++]);
         } else if (0 == strcmp (arg, "ram-slop")) {
           i++;
           if (i == argc)
             die ("@MLton ram-slop missing argument.");
           s->controls.ratios.ramSlop = stringToFloat (argv[i++]);
+        } else if (0 == strcmp (arg, "reserve-heap")) {
+          i++;
+          if (i == argc)
+            die ("@MLton reserve-heap missing argument.");
+          s->controls.reserveHeap = stringToBool (argv[i++]);
         } else if (0 == strcmp (arg, "show-sources")) {
           showSources (s);
           exit (0);
@@ -236,6 +447,23 @@ int processAtMLton (GC_state s, int argc, char **argv,
           unless (0.0 <= s->controls.ratios.stackShrink
                   and s->controls.ratios.stackShrink <= 1.0)
             die ("@MLton stack-shrink-ratio argument must be between 0.0 and 1.0.");
+        } else if (0 == strcmp (arg, "stats-segment")) {
+          i++;
+          if (i == argc)
+            die ("@MLton stats-segment missing argument.");
+          s->controls.statsSegment = argv[i++];
+        } else if (0 == strcmp (arg, "survivor-ratio")) {
+          i++;
+          if (i == argc)
+            die ("@MLton survivor-ratio missing argument.");
+          s->controls.ratios.survivor = stringToFloat (argv[i++]);
+          unless (4.0 <= s->controls.ratios.survivor)
+            die ("@MLton survivor-ratio argument must be at least 4.0.");
+        } else if (0 == strcmp (arg, "tenuring-threshold")) {
+          i++;
+          if (i == argc)
+            die ("@MLton tenuring-threshold missing argument.");
+          s->controls.tenuringThreshold = stringToTenuringThreshold (argv[i++]);
         } else if (0 == strcmp (arg, "use-mmap")) {
           i++;
           if (i == argc)
@@ -268,13 +496,34 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->amOriginal = TRUE;
   s->atomicState = 0;
   s->callFromCHandlerThread = BOGUS_OBJPTR;
+  s->controls.adaptiveNursery = FALSE;
+  s->controls.allocSampleBytes = 0;
+  s->controls.allocSampleFile = "mlalloc.out";
+  s->controls.compressWorld = FALSE;
+  s->controls.concurrentMark = FALSE;
+  s->controls.deltaWorld = FALSE;
   s->controls.fixedHeap = 0;
+  s->controls.gcLog = NULL;
+  s->controls.gcThreads = 1;
+  s->controls.heapCensus = 0;
+  s->controls.heapCensusFile = "mlcensus.out";
+  s->controls.heapDumpFile = "mlheap.out";
+  s->controls.heapDumpSignal = 0;
+  s->controls.heapRelease = GC_HEAP_RELEASE_UNMAP;
+  s->controls.hugePages = GC_HUGE_PAGES_NONE;
+  s->controls.largeObjectSize = 0;
+  s->controls.mapWorld = TRUE;
+  s->controls.markRegion = FALSE;
   s->controls.maxHeap = 0;
+  s->controls.maxMinorPause = 0;
+  s->controls.maxPause = 0;
   s->controls.mayLoadWorld = TRUE;
   s->controls.mayPageHeap = FALSE;
   s->controls.mayProcessAtMLton = TRUE;
   s->controls.messages = FALSE;
+  s->controls.numaPolicy = GC_NUMA_POLICY_DEFAULT;
   s->controls.oldGenArraySize = 0x100000;
+  s->controls.profileFormat = GC_PROFILE_FORMAT_MLMON;
   s->controls.ratios.copy = 4.0f;
   s->controls.ratios.copyGenerational = 4.0f;
   s->controls.ratios.grow = 8.0f;
@@ -290,11 +539,19 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->controls.ratios.stackCurrentShrink = 0.5f;
   s->controls.ratios.stackMaxReserved = 8.0f;
   s->controls.ratios.stackShrink = 0.5f;
+  s->controls.ratios.survivor = 16.0f;
+  s->controls.reserveHeap = FALSE;
+  s->controls.statsSegment = NULL;
   s->controls.summary = FALSE;
+  s->controls.tenuringThreshold = 0;
   s->cumulativeStatistics.bytesAllocated = 0;
   s->cumulativeStatistics.bytesCopied = 0;
   s->cumulativeStatistics.bytesCopiedMinor = 0;
+  s->cumulativeStatistics.bytesCopiedToHoles = 0;
+  s->cumulativeStatistics.bytesCopiedToSurvivors = 0;
+  s->cumulativeStatistics.bytesDiscarded = 0;
   s->cumulativeStatistics.bytesHashConsed = 0;
+  s->cumulativeStatistics.bytesLargeObjects = 0;
   s->cumulativeStatistics.bytesMarkCompacted = 0;
   s->cumulativeStatistics.bytesScannedMinor = 0;
   s->cumulativeStatistics.maxBytesLive = 0;
@@ -302,10 +559,15 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->cumulativeStatistics.maxPauseTime = 0;
   s->cumulativeStatistics.maxStackSize = 0;
   s->cumulativeStatistics.numCardsMarked = 0;
+  s->cumulativeStatistics.numConcurrentMarks = 0;
   s->cumulativeStatistics.numCopyingGCs = 0;
   s->cumulativeStatistics.numHashConsGCs = 0;
+  s->cumulativeStatistics.numIncrementalMarks = 0;
+  s->cumulativeStatistics.numLargeObjects = 0;
   s->cumulativeStatistics.numMarkCompactGCs = 0;
+  s->cumulativeStatistics.numMarkSlices = 0;
   s->cumulativeStatistics.numMinorGCs = 0;
+  memset (s->cumulativeStatistics.pauses, 0, sizeof (s->cumulativeStatistics.pauses));
   rusageZero (&s->cumulativeStatistics.ru_gc);
   rusageZero (&s->cumulativeStatistics.ru_gcCopying);
   rusageZero (&s->cumulativeStatistics.ru_gcMarkCompact);
@@ -313,10 +575,21 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->currentThread = BOGUS_OBJPTR;
   s->hashConsDuringGC = FALSE;
   initHeap (s, &s->heap);
+  initLargeObjects (s);
   s->lastMajorStatistics.bytesHashConsed = 0;
   s->lastMajorStatistics.bytesLive = 0;
   s->lastMajorStatistics.kind = GC_COPYING;
   s->lastMajorStatistics.numMinorGCs = 0;
+  s->lastWorld.chain = NULL;
+  s->lastWorld.chainLength = 0;
+  s->lastWorld.fileName = NULL;
+  s->lastWorld.id = 0;
+  s->lastWorld.numPages = 0;
+  s->lastWorld.pageHashes = NULL;
+  s->lastWorld.start = NULL;
+  s->mappedWorld.mapped = FALSE;
+  s->markCompactDuringGC = FALSE;
+  s->safepointRequests = 0;
   s->savedThread = BOGUS_OBJPTR;
   initHeap (s, &s->secondaryHeap);
   s->signalHandlerThread = BOGUS_OBJPTR;
@@ -326,6 +599,7 @@ int GC_init (GC_state s, int argc, char **argv) {
   s->signalsInfo.signalIsPending = FALSE;
   sigemptyset (&s->signalsInfo.signalsHandled);
   sigemptyset (&s->signalsInfo.signalsPending);
+  s->sysvals.hugePageSize = 0;
   s->sysvals.pageSize = GC_pageSize ();
   s->sysvals.physMem = GC_physMem ();
   s->weaks = NULL;
@@ -347,6 +621,16 @@ int GC_init (GC_state s, int argc, char **argv) {
   unless (s->controls.ratios.stackCurrentPermitReserved
           <= s->controls.ratios.stackCurrentMaxReserved)
     die ("Ratios must satisfy stack-current-permit-reserved <= stack-current-max-reserved.");
+  initAdaptiveNursery (s);
+  initAllocSampler (s);
+  initConcurrentMark (s);
+  initEventLog (s);
+  initHeapCensus (s);
+  initHeapDump (s);
+  initMarkRegion (s);
+  initParallel (s);
+  initStatsSegment (s);
+  initSurvivorSpaces (s);
   /* We align s->sysvals.ram by s->sysvals.pageSize so that we can
    * test whether or not we we are using mark-compact by comparing
    * heap size to ram size.  If we didn't round, the size might be
@@ -362,6 +646,20 @@ int GC_init (GC_state s, int argc, char **argv) {
              uintmaxToCommaString(s->sysvals.physMem),
              uintmaxToCommaString(s->sysvals.ram),
              100.0 * ((double)ram / (double)(s->sysvals.physMem)));
+  unless (GC_HUGE_PAGES_NONE == s->controls.hugePages) {
+    s->sysvals.hugePageSize = GC_hugePageSize ();
+    if (s->sysvals.hugePageSize <= s->sysvals.pageSize
+        or not isAligned (s->sysvals.hugePageSize, s->sysvals.pageSize))
+      s->sysvals.hugePageSize = 0;
+    if (DEBUG or s->controls.messages) {
+      if (0 == s->sysvals.hugePageSize)
+        fprintf (stderr, "[GC: Found no huge pages; using %s bytes pages.]\n",
+                 uintmaxToCommaString(s->sysvals.pageSize));
+      else
+        fprintf (stderr, "[GC: Found huge pages of %s bytes.]\n",
+                 uintmaxToCommaString(s->sysvals.hugePageSize));
+    }
+  }
   if (DEBUG_SOURCES or DEBUG_PROFILE) {
     uint32_t i;
     for (i = 0; i < s->sourceMaps.frameSourcesLength; i++) {
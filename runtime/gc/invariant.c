@@ -67,7 +67,9 @@ bool invariantForGC (GC_state s) {
   assert (s->heap.nursery <= s->frontier);
   unless (0 == s->heap.size) {
     assert (s->frontier <= s->limitPlusSlop);
-    assert (s->limit == s->limitPlusSlop - GC_HEAP_LIMIT_SLOP);
+    /* The limit may be zeroed for a safepoint; see safepoint.h. */
+    assert (s->limit == s->limitPlusSlop - GC_HEAP_LIMIT_SLOP
+            or NULL == s->limit);
     assert (hasHeapBytesFree (s, 0, 0));
   }
   assert (s->secondaryHeap.start == NULL 
@@ -83,6 +85,11 @@ bool invariantForGC (GC_state s) {
     fprintf (stderr, "Checking nursery.\n");
   foreachObjptrInRange (s, s->heap.nursery, &s->frontier, 
                         assertIsObjptrInFromSpace, FALSE);
+  if (DEBUG_DETAILED)
+    fprintf (stderr, "Checking survivors.\n");
+  if (sizeofSurvivors (s) > 0)
+    foreachObjptrInRange (s, s->survivorSpaces.from, &s->survivorSpaces.back,
+                          assertIsObjptrInFromSpace, FALSE);
   /* Current thread. */
   GC_stack stack = getStackCurrent(s);
   assert (isStackReservedAligned (s, stack->reserved));
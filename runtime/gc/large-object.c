@@ -0,0 +1,209 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initLargeObjects (GC_state s) {
+  struct GC_largeObjectSpace *los;
+
+  los = &s->largeObjects;
+  los->bytes = 0;
+  los->bytesAllocated = 0;
+  los->bytesLive = 0;
+  los->epoch = 0;
+  los->objects = NULL;
+}
+
+/* Only valid for a pointer to an object. */
+bool isPointerInLargeObjectSpace (GC_state s, pointer p) {
+  return p < s->heap.start or s->heap.start + s->heap.size <= p;
+}
+
+#if ASSERT
+bool isPointerToLargeObject (GC_state s, pointer p) {
+  struct GC_largeObject *lo;
+
+  for (lo = s->largeObjects.objects; lo != NULL; lo = lo->next)
+    if (p == getLargeObjectArray (s, lo))
+      return TRUE;
+  return FALSE;
+}
+#endif
+
+/* The offset of the array from the start of its mapping, such that
+ * the array's data is aligned.
+ */
+size_t offsetofLargeObjectArray (GC_state s) {
+  return align (sizeof (struct GC_largeObject) + GC_ARRAY_HEADER_SIZE,
+                s->alignment)
+         - GC_ARRAY_HEADER_SIZE;
+}
+
+struct GC_largeObject *getLargeObject (GC_state s, pointer p) {
+  return (struct GC_largeObject *)(p - (size_t)p % s->sysvals.pageSize);
+}
+
+pointer getLargeObjectArray (GC_state s, struct GC_largeObject *lo) {
+  return (pointer)lo + offsetofLargeObjectArray (s) + GC_ARRAY_HEADER_SIZE;
+}
+
+/* The array has no object pointers to follow, so the GC threads that
+ * mark it concurrently all store the same epoch.
+ */
+void markLargeObject (GC_state s, pointer p) {
+  __atomic_store_n (&getLargeObject (s, p)->mark, s->largeObjects.epoch,
+                    __ATOMIC_RELAXED);
+}
+
+bool isLargeObjectMarked (GC_state s, pointer p) {
+  return getLargeObject (s, p)->mark == s->largeObjects.epoch
+         or isPointerMarked (p);
+}
+
+void startLargeObjectMark (GC_state s) {
+  s->largeObjects.epoch++;
+}
+
+/* allocLargeObject (s, bytes, ensureBytesFree)
+ *
+ * Map a large object for an array of bytes bytes, and return where
+ * the array starts, or NULL if the array should be allocated in the
+ * old generation instead.  Dead large objects are only unmapped by
+ * a major GC, which is forced once the large objects mapped since the
+ * last one exceed both those that it kept and the heap.  Large
+ * objects count against fixed-heap and max-heap.
+ */
+pointer allocLargeObject (GC_state s, size_t bytes, size_t ensureBytesFree) {
+  struct GC_largeObjectSpace *los;
+  struct GC_largeObject *lo;
+  size_t limit, size;
+  bool forceMajor;
+
+  los = &s->largeObjects;
+  if (bytes > SIZE_MAX - offsetofLargeObjectArray (s) - s->sysvals.pageSize)
+    return NULL;
+  size = align (offsetofLargeObjectArray (s) + bytes, s->sysvals.pageSize);
+  forceMajor = los->bytesAllocated > max (los->bytesLive, s->heap.size);
+  if (forceMajor or not hasHeapBytesFree (s, 0, ensureBytesFree)) {
+    enter (s);
+    performGC (s, 0, ensureBytesFree, forceMajor, TRUE);
+    leave (s);
+  }
+  limit = (s->controls.fixedHeap > 0) ? s->controls.fixedHeap : s->controls.maxHeap;
+  if (limit > 0
+      and (s->heap.withMapsSize + s->secondaryHeap.withMapsSize + los->bytes
+           > limit - min (limit, size)))
+    return NULL;
+  lo = GC_mmapAnon (NULL, size);
+  if ((void*)-1 == lo)
+    return NULL;
+  /* An array allocated during a concurrent mark is live. */
+  lo->mark = isConcurrentMarkActive (s) ? los->epoch : los->epoch - 1;
+  lo->next = los->objects;
+  lo->size = size;
+  los->objects = lo;
+  los->bytes += size;
+  los->bytesAllocated += size;
+  s->cumulativeStatistics.bytesLargeObjects += size;
+  s->cumulativeStatistics.numLargeObjects++;
+  return (pointer)lo + offsetofLargeObjectArray (s);
+}
+
+/* Unmap the large objects that the last mark did not reach, and clear
+ * the marks of the others.  Only valid once a mark is complete.
+ */
+void sweepLargeObjects (GC_state s) {
+  struct GC_largeObjectSpace *los;
+  struct GC_largeObject **lop;
+  size_t bytesFreed, numFreed, numKept;
+
+  los = &s->largeObjects;
+  bytesFreed = 0;
+  numFreed = 0;
+  numKept = 0;
+  lop = &los->objects;
+  while (*lop != NULL) {
+    struct GC_largeObject *lo;
+    pointer p;
+
+    lo = *lop;
+    p = getLargeObjectArray (s, lo);
+    if (isLargeObjectMarked (s, p)) {
+      *(getHeaderp (p)) = getHeader (p) & ~MARK_MASK;
+      numKept++;
+      lop = &lo->next;
+    } else {
+      *lop = lo->next;
+      bytesFreed += lo->size;
+      numFreed++;
+      GC_release (lo, lo->size);
+    }
+  }
+  los->bytes -= bytesFreed;
+  los->bytesAllocated = 0;
+  los->bytesLive = los->bytes;
+  if ((DEBUG or s->controls.messages) and numKept + numFreed > 0)
+    fprintf (stderr,
+             "[GC:\tfreed %s bytes in %s large objects, kept %s bytes in %s.]\n",
+             uintmaxToCommaString(bytesFreed),
+             uintmaxToCommaString(numFreed),
+             uintmaxToCommaString(los->bytes),
+             uintmaxToCommaString(numKept));
+}
+
+void absorbObjptrForLargeObjects (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  if (isPointerInLargeObjectSpace (s, p)) {
+    assert (GC_FORWARDED == getHeader (p));
+    *opp = *((objptr*)p);
+  }
+}
+
+/* Move the large objects to the end of the old generation, which must
+ * have room for them, and unmap them.  A saved world only holds the
+ * heap.
+ */
+void absorbLargeObjects (GC_state s) {
+  struct GC_largeObjectSpace *los;
+  struct GC_largeObject *lo;
+  pointer front, limit;
+
+  los = &s->largeObjects;
+  if (NULL == los->objects)
+    return;
+  cancelConcurrentMark (s);
+  front = s->heap.start + s->heap.oldGenSize;
+  for (lo = los->objects; lo != NULL; lo = lo->next) {
+    pointer p;
+    size_t size;
+
+    p = getLargeObjectArray (s, lo);
+    size = sizeofObject (s, p);
+    assert (front + size <= s->heap.nursery);
+    GC_memcpy (p - GC_ARRAY_HEADER_SIZE, front, size);
+    *(getHeaderp (p)) = GC_FORWARDED;
+    *((objptr*)p) = pointerToObjptr (front + GC_ARRAY_HEADER_SIZE,
+                                     s->heap.start);
+    front += size;
+  }
+  limit = s->heap.start + s->heap.oldGenSize;
+  foreachGlobalObjptr (s, absorbObjptrForLargeObjects);
+  foreachObjptrInRange (s, alignFrontier (s, s->heap.start), &limit,
+                        absorbObjptrForLargeObjects, FALSE);
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr,
+             "[GC: Moved %s bytes of large objects into the old generation.]\n",
+             uintmaxToCommaString((size_t)(front - limit)));
+  s->heap.oldGenSize = (size_t)(front - s->heap.start);
+  while (los->objects != NULL) {
+    lo = los->objects;
+    los->objects = lo->next;
+    GC_release (lo, lo->size);
+  }
+  los->bytes = 0;
+  los->bytesAllocated = 0;
+  los->bytesLive = 0;
+}
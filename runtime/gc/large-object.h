@@ -0,0 +1,64 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With large-object-size, an array without object pointers of at
+ * least that many bytes is allocated outside the heap, in a mapping
+ * of its own, and is never copied or slid by a GC.  The mapping
+ * starts with a GC_largeObject, followed by the array, whose data is
+ * in the first page of the mapping; so, the GC_largeObject of an
+ * array can be found by rounding its address down to a page.
+ *
+ * Only arrays without object pointers qualify, because the mutator
+ * marks the card of an object that it writes a pointer into, and
+ * there are no cards outside the heap.
+ *
+ * Any object pointer that does not point into the heap points to a
+ * large object.  Every mark of the old generation also marks the
+ * large objects that it reaches: a Cheney copy, a parallel mark, and
+ * a concurrent mark record the current epoch in the GC_largeObject,
+ * while a serial mark sets the mark bit of the array's header.  Once
+ * a mark is complete, the unmarked large objects are unmapped.  A
+ * mark starts a new epoch, so the marks of an abandoned cycle expire
+ * with it.
+ */
+struct GC_largeObject {
+  uint32_t mark; /* Epoch of the last mark that reached the array. */
+  struct GC_largeObject *next;
+  size_t size; /* Bytes mapped, including this GC_largeObject. */
+};
+
+struct GC_largeObjectSpace {
+  size_t bytes; /* Bytes mapped for large objects. */
+  size_t bytesAllocated; /* Bytes mapped since the last sweep. */
+  size_t bytesLive; /* Bytes kept by the last sweep. */
+  uint32_t epoch;
+  struct GC_largeObject *objects;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initLargeObjects (GC_state s);
+static inline bool isPointerInLargeObjectSpace (GC_state s, pointer p);
+#if ASSERT
+static bool isPointerToLargeObject (GC_state s, pointer p);
+#endif
+static inline size_t offsetofLargeObjectArray (GC_state s);
+static inline struct GC_largeObject *getLargeObject (GC_state s, pointer p);
+static inline pointer getLargeObjectArray (GC_state s, struct GC_largeObject *lo);
+static inline void markLargeObject (GC_state s, pointer p);
+static inline bool isLargeObjectMarked (GC_state s, pointer p);
+static inline void startLargeObjectMark (GC_state s);
+
+static pointer allocLargeObject (GC_state s, size_t bytes, size_t ensureBytesFree);
+static void sweepLargeObjects (GC_state s);
+static void absorbObjptrForLargeObjects (GC_state s, objptr *opp);
+static void absorbLargeObjects (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
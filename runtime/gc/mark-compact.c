@@ -52,6 +52,9 @@ void threadInternalObjptr (GC_state s, objptr *opp) {
 
   opop = pointerToObjptr ((pointer)opp, s->heap.start);
   p = objptrToPointer (*opp, s->heap.start);
+  /* Large objects do not move. */
+  if (isPointerInLargeObjectSpace (s, p))
+    return;
   if (FALSE)
     fprintf (stderr,
              "threadInternal opp = "FMTPTR"  p = "FMTPTR"  header = "FMTHDR"\n",
@@ -240,6 +243,7 @@ void updateBackwardPointersAndSlideForMarkCompact (GC_state s, GC_stack currentS
   front = alignFrontier (s, s->heap.start);
   back = s->heap.start + s->heap.oldGenSize;
   gap = 0;
+  startCrossMapRebuild (s);
 updateObject:
   if (DEBUG_MARK_COMPACT)
     fprintf (stderr, "updateObject  front = "FMTPTR"  back = "FMTPTR"\n",
@@ -314,6 +318,7 @@ unmark:
         fprintf (stderr, "sliding "FMTPTR" down %"PRIuMAX" to "FMTPTR"\n",
                  (uintptr_t)front, (uintmax_t)gap, (uintptr_t)(front - gap));
       GC_memmove (front, front - gap, size);
+      recordCrossMapBoundary (s, front - gap);
       gap += skipGap;
       front += size + skipFront;
       goto updateObject;
@@ -358,6 +363,7 @@ done:
   if (DEBUG_MARK_COMPACT)
     fprintf (stderr, "oldGenSize = %"PRIuMAX"\n",
              (uintmax_t)s->heap.oldGenSize);
+  finishCrossMapRebuild (s);
   return;
 }
 
@@ -378,20 +384,28 @@ void majorMarkCompactGC (GC_state s) {
              (uintptr_t)(s->heap.start),
              uintmaxToCommaString(s->heap.size));
   }
-  currentStack = getStackCurrent (s);
-  if (s->hashConsDuringGC) {
-    s->lastMajorStatistics.bytesHashConsed = 0;
-    s->cumulativeStatistics.numHashConsGCs++;
-    s->objectHashTable = allocHashTable (s);
-    foreachGlobalObjptr (s, dfsMarkWithHashConsWithLinkWeaks);
-    freeHashTable (s->objectHashTable);
+  if (isConcurrentMarkActive (s) and finishConcurrentMark (s)) {
+    majorParallelCompact (s);
+    endConcurrentMark (s);
+  } else if (useParallelMarkCompact (s) and majorParallelMarkCompact (s)) {
+    ;
   } else {
-    foreachGlobalObjptr (s, dfsMarkWithoutHashConsWithLinkWeaks);
+    currentStack = getStackCurrent (s);
+    startLargeObjectMark (s);
+    if (s->hashConsDuringGC) {
+      s->lastMajorStatistics.bytesHashConsed = 0;
+      s->cumulativeStatistics.numHashConsGCs++;
+      s->objectHashTable = allocHashTable (s);
+      foreachGlobalObjptr (s, dfsMarkWithHashConsWithLinkWeaks);
+      freeHashTable (s->objectHashTable);
+    } else {
+      foreachGlobalObjptr (s, dfsMarkWithoutHashConsWithLinkWeaks);
+    }
+    updateWeaksForMarkCompact (s);
+    foreachGlobalObjptr (s, threadInternalObjptr);
+    updateForwardPointersForMarkCompact (s, currentStack);
+    updateBackwardPointersAndSlideForMarkCompact (s, currentStack);
   }
-  updateWeaksForMarkCompact (s);
-  foreachGlobalObjptr (s, threadInternalObjptr);
-  updateForwardPointersForMarkCompact (s, currentStack);
-  updateBackwardPointersAndSlideForMarkCompact (s, currentStack);
   bytesHashConsed = s->lastMajorStatistics.bytesHashConsed;
   s->cumulativeStatistics.bytesHashConsed += bytesHashConsed;
   bytesMarkCompacted = s->heap.oldGenSize;
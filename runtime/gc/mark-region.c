@@ -0,0 +1,426 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initMarkRegion (GC_state s) {
+  struct GC_markRegion *mr;
+
+  mr = &s->markRegion;
+  mr->holeBytes = 0;
+  mr->holes = NULL;
+  mr->holesCapacity = 0;
+  mr->holesSize = 0;
+  mr->nextHole = 0;
+}
+
+/* The holes are not used while an old generation mark is active,
+ * since the mark would miss the objects promoted into them.
+ */
+bool useHolesForMinor (GC_state s) {
+  return s->markRegion.nextHole < s->markRegion.holesSize
+         and not isConcurrentMarkActive (s);
+}
+
+void clearHoles (GC_state s) {
+  s->markRegion.holeBytes = 0;
+  s->markRegion.holesSize = 0;
+  s->markRegion.nextHole = 0;
+}
+
+void addHole (GC_state s, pointer front, pointer back) {
+  struct GC_markRegion *mr;
+  struct GC_hole *h;
+
+  mr = &s->markRegion;
+  if (mr->holesSize == mr->holesCapacity) {
+    struct GC_hole *holes;
+    size_t capacity;
+
+    capacity = (0 == mr->holesCapacity) ? 1024 : 2 * mr->holesCapacity;
+    holes = (struct GC_hole*)(calloc_safe (capacity, sizeof (struct GC_hole)));
+    if (mr->holesSize > 0)
+      memcpy (holes, mr->holes, mr->holesSize * sizeof (struct GC_hole));
+    free (mr->holes);
+    mr->holes = holes;
+    mr->holesCapacity = capacity;
+  }
+  h = &mr->holes[mr->holesSize++];
+  h->start = (size_t)(front - s->heap.start);
+  h->back = h->start;
+  h->end = (size_t)(back - s->heap.start);
+  mr->holeBytes += (size_t)(back - front);
+}
+
+/* ---------------------------------------------------------------- */
+/*                          Dense Prefix                            */
+/* ---------------------------------------------------------------- */
+
+/* Returns the number of lines of region r with a live granule. */
+size_t countLiveLines (struct GC_parallelState *ps, size_t r) {
+  size_t bitsPerLine, first, last, lines;
+
+  bitsPerLine = GC_LINE_SIZE / GC_MODEL_MINALIGN;
+  first = r * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN / GC_MARK_MAP_BITS);
+  last = first + GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN / GC_MARK_MAP_BITS;
+  lines = 0;
+  if (bitsPerLine < GC_MARK_MAP_BITS) {
+    uint64_t mask;
+
+    mask = ((uint64_t)1 << bitsPerLine) - 1;
+    for (size_t k = first; k < last; k++) {
+      if (0 == ps->liveMap[k])
+        continue;
+      for (size_t b = 0; b < GC_MARK_MAP_BITS; b += bitsPerLine)
+        if (0 != ((ps->liveMap[k] >> b) & mask))
+          lines++;
+    }
+  } else {
+    for (size_t k = first; k < last; k += bitsPerLine / GC_MARK_MAP_BITS) {
+      uint64_t bits;
+
+      bits = 0;
+      for (size_t j = 0; j < bitsPerLine / GC_MARK_MAP_BITS; j++)
+        bits |= ps->liveMap[k + j];
+      if (0 != bits)
+        lines++;
+    }
+  }
+  return lines;
+}
+
+/* Returns the number of regions, counted from the start of the old
+ * generation, to keep in place.  Expects ps->regionOffsets to hold the
+ * live granules of each region, not yet summed.
+ */
+size_t findDensePrefix (GC_state s) {
+  struct GC_parallelState *ps;
+  pointer oldGenEnd;
+  size_t freeBytes, r, wasteBytes;
+
+  ps = &s->parallelState;
+  oldGenEnd = s->heap.start + s->heap.oldGenSize;
+  freeBytes = 0;
+  wasteBytes = 0;
+  for (r = 0; r < ps->numRegions; r++) {
+    pointer regionStart;
+    size_t lineBytes, size;
+
+    regionStart =
+      getGranulePointer (ps, r * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN));
+    size = min (GC_PARALLEL_REGION_SIZE, (size_t)(oldGenEnd - regionStart));
+    lineBytes = ps->regionLines[r] * GC_LINE_SIZE;
+    wasteBytes += lineBytes - ps->regionOffsets[r] * GC_MODEL_MINALIGN;
+    if (lineBytes < size)
+      freeBytes += size - lineBytes;
+    if (wasteBytes > s->heap.oldGenSize / GC_MARK_REGION_WASTE_RATIO
+        or freeBytes > s->heap.oldGenSize / GC_MARK_REGION_HOLE_RATIO)
+      break;
+  }
+  return r;
+}
+
+/* setCompactBase (s, r, live)
+ *
+ * Set ps->compactBase to the end of the live objects that start before
+ * region r, which are kept in place, and ps->compactLive to the number
+ * of live granules below it.  Expects ps->regionOffsets to hold the
+ * live granules before each region, and live to be their total.
+ */
+void setCompactBase (GC_state s, size_t r, size_t live) {
+  struct GC_parallelState *ps;
+  size_t first, i, k;
+
+  ps = &s->parallelState;
+  first = r * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN);
+  k = first / GC_MARK_MAP_BITS;
+  if (r < ps->numRegions
+      and 1 == (ps->liveMap[k] & 1)
+      and 0 == (ps->startMap[k] & 1)) {
+    /* An object that starts before region r extends into it. */
+    for (i = ps->mapWords * GC_MARK_MAP_BITS; k < ps->mapWords; k++) {
+      uint64_t bits;
+
+      bits = ~ps->liveMap[k] | ps->startMap[k];
+      if (0 != bits) {
+        i = k * GC_MARK_MAP_BITS + (size_t)__builtin_ctzll (bits);
+        break;
+      }
+    }
+    ps->compactLive = ps->regionOffsets[r] + (i - first);
+  } else {
+    for (i = 0; k > 0; k--)
+      if (0 != ps->liveMap[k - 1]) {
+        i = k * GC_MARK_MAP_BITS - (size_t)__builtin_clzll (ps->liveMap[k - 1]);
+        break;
+      }
+    ps->compactLive = (r < ps->numRegions) ? ps->regionOffsets[r] : live;
+  }
+  ps->compactBase = getGranulePointer (ps, i);
+}
+
+/* findNextMarkBit (map, set, i, end)
+ *
+ * Returns the index of the first bit at or after i that is set (or
+ * clear, if set is FALSE), or end if there is none before end.
+ */
+size_t findNextMarkBit (uint64_t *map, bool set, size_t i, size_t end) {
+  while (i < end) {
+    uint64_t bits;
+
+    bits = set ? map[i / GC_MARK_MAP_BITS] : ~map[i / GC_MARK_MAP_BITS];
+    bits &= ~(uint64_t)0 << (i % GC_MARK_MAP_BITS);
+    if (0 != bits)
+      return min (end, (i - i % GC_MARK_MAP_BITS) + (size_t)__builtin_ctzll (bits));
+    i = align (i + 1, GC_MARK_MAP_BITS);
+  }
+  return end;
+}
+
+/* ---------------------------------------------------------------- */
+/*                             Sweep                                */
+/* ---------------------------------------------------------------- */
+
+void clearObjptr (__attribute__ ((unused)) GC_state s, objptr *opp) {
+  *opp = BOGUS_OBJPTR;
+}
+
+/* sweepGap (s, front, back)
+ *
+ * Fill the dead objects in [front, back).  A gap that is too small to
+ * fill keeps its dead objects, but without object pointers, so that
+ * walks through the old generation see nothing stale.  Either way,
+ * the boundaries left in the gap are recorded in the crossMap.
+ */
+void sweepGap (GC_state s, pointer front, pointer back) {
+  if (isFillableGap ((size_t)(back - front))) {
+    fillGap (s, front, back);
+    if (front < back)
+      recordCrossMapBoundary (s, front);
+    return;
+  }
+  while (front < back) {
+    pointer p;
+
+    p = advanceToObjectData (s, front);
+    foreachObjptrInObject (s, p, clearObjptr, FALSE);
+    recordCrossMapBoundary (s, front);
+    front += sizeofObject (s, p);
+  }
+  assert (front == back);
+}
+
+/* Sweep the gaps after the live objects that start in each region
+ * below ps->compactBase, and shrink their stacks.  A stack is only
+ * shrunk if the gap after it can be filled; otherwise its live
+ * granules are extended to its full size, so that findHoles does not
+ * mistake its tail for free space.
+ */
+void sweepRegionsJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t end, granulesPerRegion, i, n, r;
+
+  ps = s->worker->parallel;
+  granulesPerRegion = GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN;
+  end = getGranuleIndex (ps, ps->compactBase);
+  while (claimRegion (ps, &r)) {
+    i = r * granulesPerRegion;
+    if (i >= end)
+      break;
+    if (0 == r) {
+      n = findNextMarkBit (ps->startMap, TRUE, 0, end);
+      sweepGap (s, ps->markBase, getGranulePointer (ps, n));
+    }
+    while (nextObjectInRegion (ps, r, &i) and i < end) {
+      pointer p;
+      size_t copyBytes, e, reservedNew, size;
+      GC_objectTypeTag tag;
+
+      p = advanceToObjectData (s, getGranulePointer (ps, i));
+      recordCrossMapBoundary (s, getGranulePointer (ps, i));
+      size = sizeofObjectForParallelCompact (s, p, &copyBytes, &reservedNew);
+      e = i + size / GC_MODEL_MINALIGN;
+      n = findNextMarkBit (ps->startMap, TRUE, e, end);
+      splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+      if (STACK_TAG == tag) {
+        if (isFillableGap ((n - e) * GC_MODEL_MINALIGN)) {
+          shrinkStackForParallelCompact (s, (GC_stack)p, reservedNew);
+        } else {
+          size_t last;
+
+          last = i + sizeofObject (s, p) / GC_MODEL_MINALIGN;
+          assert (last <= n);
+          setLiveGranules (ps, e, last);
+          e = last;
+        }
+      }
+      sweepGap (s, getGranulePointer (ps, e), getGranulePointer (ps, n));
+      i = n;
+    }
+  }
+}
+
+/* Count the live objects below ps->compactBase by their start bits,
+ * which skip the dead objects and fillers that the sweep leaves, and
+ * the objects slid above it, for the heap census.
+ */
+void countSweptRegionsForHeapCensus (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t end, i;
+
+  ps = &s->parallelState;
+  end = getGranuleIndex (ps, ps->compactBase);
+  for (i = findNextMarkBit (ps->startMap, TRUE, 0, end);
+       i < end;
+       i = findNextMarkBit (ps->startMap, TRUE, i + 1, end)) {
+    pointer p;
+
+    p = advanceToObjectData (s, getGranulePointer (ps, i));
+    countObjectForHeapCensus (s, p, sizeofObject (s, p));
+  }
+  countRangeForHeapCensus (s, ps->compactBase, s->heap.start + s->heap.oldGenSize);
+  s->heapCensus.oldGenCounted = TRUE;
+}
+
+/* Record each run of free lines below ps->compactBase as a hole. */
+void findHoles (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t end, i, j;
+
+  ps = &s->parallelState;
+  end = getGranuleIndex (ps, ps->compactBase);
+  for (i = findNextMarkBit (ps->liveMap, FALSE, 0, end);
+       i < end;
+       i = findNextMarkBit (ps->liveMap, FALSE, j, end)) {
+    j = findNextMarkBit (ps->liveMap, TRUE, i, end);
+    if ((j - i) * GC_MODEL_MINALIGN >= GC_LINE_SIZE)
+      addHole (s, getGranulePointer (ps, i), getGranulePointer (ps, j));
+  }
+  if (DEBUG_PARALLEL or s->controls.messages)
+    fprintf (stderr,
+             "[GC:\tkept %s bytes in place, with %s bytes in %s holes.]\n",
+             uintmaxToCommaString((size_t)(ps->compactBase - s->heap.start)),
+             uintmaxToCommaString(s->markRegion.holeBytes),
+             uintmaxToCommaString(s->markRegion.holesSize));
+}
+
+/* ---------------------------------------------------------------- */
+/*                    Promotion into the Holes                      */
+/* ---------------------------------------------------------------- */
+
+/* allocHoleForForward (s, bytes)
+ *
+ * Returns space for bytes in the current hole, filling the rest of
+ * the hole, or NULL if the object should be promoted to the end of
+ * the old generation instead.
+ */
+pointer allocHoleForForward (GC_state s, size_t bytes) {
+  struct GC_markRegion *mr;
+
+  mr = &s->markRegion;
+  while (mr->nextHole < mr->holesSize) {
+    struct GC_hole *h;
+    size_t available;
+
+    h = &mr->holes[mr->nextHole];
+    available = h->end - h->back;
+    if (bytes <= available and isFillableGap (available - bytes)) {
+      pointer p;
+
+      p = s->heap.start + h->back;
+      h->back += bytes;
+      if (h->back < h->end) {
+        fillGap (s, s->heap.start + h->back, s->heap.start + h->end);
+        addCrossMapBoundary (s, s->heap.start + h->back);
+      }
+      return p;
+    }
+    if (bytes > GC_LINE_SIZE)
+      return NULL;
+    mr->nextHole++;
+  }
+  return NULL;
+}
+
+/* Like forwardObjptr, but copies into a hole when one has room. */
+void forwardObjptrToHoles (GC_state s, objptr *opp) {
+  pointer p;
+  GC_header header;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  header = getHeader (p);
+  if (header != GC_FORWARDED) {
+    size_t size, skip;
+    size_t headerBytes;
+    pointer to;
+
+    size = sizeofObjectForForward (s, p, header, &headerBytes, &skip);
+    to = allocHoleForForward (s, size + skip);
+    if (NULL == to) {
+      to = s->forwardState.back;
+      assert (to + size + skip <= s->forwardState.toLimit);
+      s->forwardState.back += size + skip;
+    } else {
+      s->cumulativeStatistics.bytesCopiedToHoles += size + skip;
+    }
+    GC_memcpy (p - headerBytes, to, size);
+    linkWeakForForward (s, to + headerBytes, header, &s->weaks);
+    *((GC_header*)(p - GC_HEADER_SIZE)) = GC_FORWARDED;
+    *((objptr*)p) = pointerToObjptr (to + headerBytes, s->heap.start);
+  }
+  *opp = *((objptr*)p);
+}
+
+void forwardObjptrIfInNurseryToHoles (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  if (p < s->heap.nursery or isPointerInLargeObjectSpace (s, p))
+    return;
+  assert (s->heap.nursery <= p and p < s->limitPlusSlop);
+  forwardObjptrToHoles (s, opp);
+}
+
+/* Copy the nursery into the holes, and then to the end of the old
+ * generation.  The objects copied into each hole and to the end are
+ * scanned in turn until there are no more.  Returns the number of
+ * bytes copied into the holes.
+ */
+size_t minorCheneyCopyToHoles (GC_state s) {
+  struct GC_markRegion *mr;
+  uintmax_t bytesCopiedToHoles;
+  pointer scan, tailScan;
+  size_t scanHole;
+
+  mr = &s->markRegion;
+  bytesCopiedToHoles = s->cumulativeStatistics.bytesCopiedToHoles;
+  /* Promotion adds object boundaries to a valid crossMap. */
+  updateCrossMap (s);
+  scanHole = mr->nextHole;
+  scan = s->heap.start + mr->holes[scanHole].back;
+  tailScan = s->forwardState.toStart;
+  foreachGlobalObjptr (s, forwardObjptrIfInNurseryToHoles);
+  forwardInterGenerationalObjptrs (s, forwardObjptrIfInNurseryToHoles);
+  while (TRUE) {
+    pointer back;
+
+    back = s->heap.start + mr->holes[scanHole].back;
+    if (scan < back)
+      scan = foreachObjptrInRange (s, scan, &back,
+                                   forwardObjptrIfInNurseryToHoles, TRUE);
+    else if (scanHole < mr->nextHole and scanHole + 1 < mr->holesSize)
+      scan = s->heap.start + mr->holes[++scanHole].start;
+    else if (tailScan < s->forwardState.back)
+      tailScan = foreachObjptrInRange (s, tailScan, &s->forwardState.back,
+                                       forwardObjptrIfInNurseryToHoles, TRUE);
+    else
+      break;
+  }
+  if (DEBUG_GENERATIONAL or s->controls.messages)
+    fprintf (stderr,
+             "[GC:\tcopied %s bytes into holes.]\n",
+             uintmaxToCommaString(s->cumulativeStatistics.bytesCopiedToHoles
+                                  - bytesCopiedToHoles));
+  return (size_t)(s->cumulativeStatistics.bytesCopiedToHoles - bytesCopiedToHoles);
+}
@@ -0,0 +1,74 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With mark-region, the old generation is treated as a sequence of
+ * blocks, which are the regions of the parallel mark-compact (see
+ * parallel-mark-compact.h), each divided into lines of GC_LINE_SIZE
+ * bytes.  A major GC always marks, so no copy reserve is needed, and
+ * counts the lines of each block that hold part of a live object.
+ * Blocks are kept in place up to the first block at which the bytes
+ * of free lines or the dead bytes in live lines, counted from the
+ * start of the old generation, become too large; only the blocks
+ * after that are compacted.
+ *
+ * The dead space between the live objects that are kept is filled, and
+ * each run of free lines becomes a hole.  Holes are offsets from
+ * heap.start, so they survive moving the heap.  Until the next major
+ * GC, a minor GC promotes objects into the holes, in address order,
+ * before it extends the old generation.  An object larger than a line
+ * that does not fit in the current hole is promoted to the end of the
+ * old generation instead of skipping the rest of the hole.
+ */
+struct GC_hole {
+  size_t back; /* Objects are promoted into [back, end). */
+  size_t end;
+  size_t start;
+};
+
+struct GC_markRegion {
+  size_t holeBytes; /* Bytes in holes at the last major GC. */
+  struct GC_hole *holes; /* In address order. */
+  size_t holesCapacity;
+  size_t holesSize;
+  size_t nextHole; /* Holes before nextHole are full. */
+};
+
+#define GC_LINE_SIZE CARD_SIZE
+
+/* The kept blocks end before the bytes of free lines exceed
+ * 1 / GC_MARK_REGION_HOLE_RATIO of the old generation, or the dead
+ * bytes in live lines exceed 1 / GC_MARK_REGION_WASTE_RATIO of it.
+ */
+#define GC_MARK_REGION_HOLE_RATIO 4
+#define GC_MARK_REGION_WASTE_RATIO 16
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initMarkRegion (GC_state s);
+static inline bool useHolesForMinor (GC_state s);
+static inline void clearHoles (GC_state s);
+static void addHole (GC_state s, pointer front, pointer back);
+
+static size_t countLiveLines (struct GC_parallelState *ps, size_t r);
+static size_t findDensePrefix (GC_state s);
+static void setCompactBase (GC_state s, size_t r, size_t live);
+static size_t findNextMarkBit (uint64_t *map, bool set, size_t i, size_t end);
+static void clearObjptr (GC_state s, objptr *opp);
+static void sweepGap (GC_state s, pointer front, pointer back);
+static void sweepRegionsJob (GC_state s);
+static void countSweptRegionsForHeapCensus (GC_state s);
+static void findHoles (GC_state s);
+
+static pointer allocHoleForForward (GC_state s, size_t bytes);
+static void forwardObjptrToHoles (GC_state s, objptr *opp);
+static void forwardObjptrIfInNurseryToHoles (GC_state s, objptr *opp);
+static size_t minorCheneyCopyToHoles (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
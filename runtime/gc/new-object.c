@@ -27,6 +27,8 @@ pointer newObject (GC_state s,
     frontier = s->heap.start + s->heap.oldGenSize;
     s->heap.oldGenSize += bytesRequested;
     s->cumulativeStatistics.bytesAllocated += bytesRequested;
+    if (useAllocSampler (s))
+      addAllocSampleBytes (s, bytesRequested);
   } else {
     if (DEBUG_DETAILED)
       fprintf (stderr, "frontier changed from "FMTPTR" to "FMTPTR"\n",
@@ -34,6 +36,7 @@ pointer newObject (GC_state s,
                (uintptr_t)(s->frontier + bytesRequested));
     frontier = s->frontier;
     s->frontier += bytesRequested;
+    countAllocSampleBytes (s);
   }
   GC_profileAllocInc (s, bytesRequested);
   *((GC_header*)frontier) = header;
@@ -96,5 +99,6 @@ static inline void setFrontier (GC_state s, pointer p,
   GC_profileAllocInc (s, (size_t)(p - s->frontier));
   s->cumulativeStatistics.bytesAllocated += (size_t)(p - s->frontier);
   s->frontier = p;
+  countAllocSampleBytes (s);
   assert (s->frontier <= s->limitPlusSlop);
 }
@@ -50,6 +50,8 @@ void GC_unpack (GC_state s) {
    */
   enterGC (s);
   minorGC (s);
+  cancelConcurrentMark (s);
+  releaseSurvivorSpaces (s);
   resizeHeap (s, s->heap.oldGenSize);
   setCardMapAndCrossMap (s);
   resizeHeapSecondary (s);
@@ -0,0 +1,608 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                            Mark Maps                             */
+/* ---------------------------------------------------------------- */
+
+size_t getGranuleIndex (struct GC_parallelState *ps, pointer p) {
+  assert (ps->markBase <= p);
+  return (size_t)(p - ps->markBase) / GC_MODEL_MINALIGN;
+}
+
+pointer getGranulePointer (struct GC_parallelState *ps, size_t i) {
+  return ps->markBase + i * GC_MODEL_MINALIGN;
+}
+
+size_t getHeaderBytes (GC_state s, pointer p) {
+  GC_objectTypeTag tag;
+
+  splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+  if (ARRAY_TAG == tag)
+    return GC_ARRAY_HEADER_SIZE;
+  else if (STACK_TAG == tag)
+    return GC_STACK_HEADER_SIZE;
+  else
+    return GC_NORMAL_HEADER_SIZE;
+}
+
+/* sizeofObjectForParallelCompact (s, p, copyBytesp, reservedNewp)
+ *
+ * Returns the size the object at p will have after it is compacted,
+ * which is smaller than sizeofObject for a stack that will be shrunk.
+ * Sets *copyBytesp to the number of bytes that must be moved, and,
+ * for a stack, *reservedNewp to its new reserved size.
+ */
+size_t sizeofObjectForParallelCompact (GC_state s, pointer p,
+                                       size_t *copyBytesp,
+                                       size_t *reservedNewp) {
+  size_t headerBytes, objectBytes, size;
+  GC_objectTypeTag tag;
+  uint16_t bytesNonObjptrs, numObjptrs;
+
+  splitHeader (s, getHeader (p), &tag, NULL, &bytesNonObjptrs, &numObjptrs);
+  if ((NORMAL_TAG == tag) or (WEAK_TAG == tag)) {
+    headerBytes = GC_NORMAL_HEADER_SIZE;
+    objectBytes = bytesNonObjptrs + (numObjptrs * OBJPTR_SIZE);
+    size = headerBytes + objectBytes;
+    *copyBytesp = size;
+  } else if (ARRAY_TAG == tag) {
+    headerBytes = GC_ARRAY_HEADER_SIZE;
+    objectBytes = sizeofArrayNoHeader (s, getArrayLength (p),
+                                       bytesNonObjptrs, numObjptrs);
+    size = headerBytes + objectBytes;
+    *copyBytesp = size;
+  } else {
+    GC_stack stack;
+    size_t reservedNew;
+
+    assert (STACK_TAG == tag);
+    headerBytes = GC_STACK_HEADER_SIZE;
+    stack = (GC_stack)p;
+    reservedNew =
+      sizeofStackShrinkReserved (s, stack,
+                                 s->worker->parallel->currentStack == stack);
+    size = headerBytes + sizeof (struct GC_stack) + reservedNew;
+    *copyBytesp = headerBytes + sizeof (struct GC_stack) + stack->used;
+    *reservedNewp = reservedNew;
+  }
+  assert (isAligned (size, GC_MODEL_MINALIGN));
+  return size;
+}
+
+/* Set the regions and map words to cover the first size bytes of the
+ * heap.
+ */
+void setMarkRegions (GC_state s, size_t size) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  ps->numRegions =
+    align ((size_t)(s->heap.start + size - ps->markBase),
+           GC_PARALLEL_REGION_SIZE)
+    / GC_PARALLEL_REGION_SIZE;
+  ps->mapWords =
+    ps->numRegions
+    * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN / GC_MARK_MAP_BITS);
+}
+
+/* Map the bitmaps and tables for the first size bytes of the heap.
+ * Returns FALSE if there is not enough memory, in which case the
+ * serial mark-compact, which needs no extra space, is used instead.
+ */
+bool allocMarkMaps (GC_state s, size_t size) {
+  struct GC_parallelState *ps;
+  size_t bytes;
+  pointer map;
+
+  ps = &s->parallelState;
+  ps->markBase = alignFrontier (s, s->heap.start);
+  setMarkRegions (s, size);
+  bytes = ps->mapWords * (2 * sizeof (uint64_t) + sizeof (size_t))
+          + ps->numRegions * (2 * sizeof (size_t) + sizeof (bool));
+  bytes = align (bytes, s->sysvals.pageSize);
+  map = GC_mmapAnon (NULL, bytes);
+  if ((void*)-1 == map) {
+    if (DEBUG_PARALLEL or s->controls.messages)
+      fprintf (stderr,
+               "[GC: Unable to allocate %s bytes of mark maps.]\n",
+               uintmaxToCommaString(bytes));
+    return FALSE;
+  }
+  ps->mapBytes = bytes;
+  ps->liveMap = (uint64_t*)map;
+  map += ps->mapWords * sizeof (uint64_t);
+  ps->startMap = (uint64_t*)map;
+  map += ps->mapWords * sizeof (uint64_t);
+  ps->blockOffsets = (size_t*)map;
+  map += ps->mapWords * sizeof (size_t);
+  ps->regionOffsets = (size_t*)map;
+  map += ps->numRegions * sizeof (size_t);
+  ps->regionLines = (size_t*)map;
+  map += ps->numRegions * sizeof (size_t);
+  ps->regionDone = (bool*)map;
+  return TRUE;
+}
+
+void freeMarkMaps (GC_state s) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  GC_release (ps->liveMap, ps->mapBytes);
+  ps->liveMap = NULL;
+  ps->startMap = NULL;
+  ps->blockOffsets = NULL;
+  ps->regionOffsets = NULL;
+  ps->regionLines = NULL;
+  ps->regionDone = NULL;
+}
+
+/* Set the live map bits of granules [first, last).  Only the words at
+ * the ends can be shared with other objects.
+ */
+void setLiveGranules (struct GC_parallelState *ps, size_t first, size_t last) {
+  while (first < last) {
+    size_t lo, hi;
+    uint64_t mask;
+
+    lo = first % GC_MARK_MAP_BITS;
+    hi = min (GC_MARK_MAP_BITS, lo + (last - first));
+    mask = (GC_MARK_MAP_BITS == hi) ? ~(uint64_t)0 : (((uint64_t)1 << hi) - 1);
+    mask &= ~(((uint64_t)1 << lo) - 1);
+    if (~(uint64_t)0 == mask)
+      __atomic_store_n (&ps->liveMap[first / GC_MARK_MAP_BITS], mask, __ATOMIC_RELAXED);
+    else
+      __atomic_fetch_or (&ps->liveMap[first / GC_MARK_MAP_BITS], mask, __ATOMIC_RELAXED);
+    first += hi - lo;
+  }
+}
+
+bool isPointerMarkedParallel (GC_state s, pointer p) {
+  struct GC_parallelState *ps;
+  size_t i;
+
+  if (isPointerInLargeObjectSpace (s, p))
+    return isLargeObjectMarked (s, p);
+  ps = &s->parallelState;
+  i = getGranuleIndex (ps, p - getHeaderBytes (s, p));
+  return 0 != (ps->startMap[i / GC_MARK_MAP_BITS]
+               & ((uint64_t)1 << (i % GC_MARK_MAP_BITS)));
+}
+
+/* ---------------------------------------------------------------- */
+/*                          Parallel Mark                           */
+/* ---------------------------------------------------------------- */
+
+void pushMarkStack (struct GC_worker *w, pointer p) {
+  if (w->markStackSize == w->markStackCapacity) {
+    pointer *stack;
+    size_t capacity;
+
+    capacity = (0 == w->markStackCapacity) ? 1024 : 2 * w->markStackCapacity;
+    stack = (pointer*)(calloc_safe (capacity, sizeof (pointer)));
+    if (w->markStackSize > 0)
+      memcpy (stack, w->markStack, w->markStackSize * sizeof (pointer));
+    free (w->markStack);
+    w->markStack = stack;
+    w->markStackCapacity = capacity;
+  }
+  w->markStack[w->markStackSize++] = p;
+}
+
+/* Move the oldest half of the mark stack, which is closest to the
+ * roots and so likely to lead to the most work, to the deque.
+ */
+void shareMarkStack (struct GC_worker *w) {
+  size_t n;
+
+  n = w->markStackSize / 2;
+  for (size_t i = 0; i < n; i++)
+    pushWorkRange (&w->deque, w->markStack[i], NULL);
+  memmove (w->markStack, w->markStack + n,
+           (w->markStackSize - n) * sizeof (pointer));
+  w->markStackSize -= n;
+}
+
+/* Mark the object pointed to by *opp, by setting its start map bit,
+ * and push it if this worker was the one to mark it.  Objects at or
+ * above ps->markLimit are not being marked.  Large objects have no
+ * start map bit, nor anything to scan.
+ */
+void markObjptrParallel (GC_state s, objptr *opp) {
+  struct GC_parallelState *ps;
+  uint64_t bit, *word;
+  pointer p;
+  size_t i;
+
+  ps = s->worker->parallel;
+  p = objptrToPointer (*opp, s->heap.start);
+  if (isPointerInLargeObjectSpace (s, p)) {
+    markLargeObject (s, p);
+    return;
+  }
+  if (p >= ps->markLimit)
+    return;
+  i = getGranuleIndex (ps, p - getHeaderBytes (s, p));
+  word = &ps->startMap[i / GC_MARK_MAP_BITS];
+  bit = (uint64_t)1 << (i % GC_MARK_MAP_BITS);
+  if (bit & __atomic_load_n (word, __ATOMIC_RELAXED))
+    return;
+  if (bit & __atomic_fetch_or (word, bit, __ATOMIC_RELAXED))
+    return;
+  pushMarkStack (s->worker, p);
+}
+
+/* Record the live granules of the marked object at p, link it if it
+ * is a weak, and mark the objects it points to.
+ */
+void scanObjectForParallelMark (GC_state s, pointer p) {
+  struct GC_worker *w;
+  size_t copyBytes, first, reservedNew, size;
+  GC_objectTypeTag tag;
+
+  w = s->worker;
+  size = sizeofObjectForParallelCompact (s, p, &copyBytes, &reservedNew);
+  first = getGranuleIndex (w->parallel, p - getHeaderBytes (s, p));
+  setLiveGranules (w->parallel, first, first + size / GC_MODEL_MINALIGN);
+  w->bytesMarked += size;
+  splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+  if (WEAK_TAG == tag) {
+    GC_weak weak;
+
+    weak = (GC_weak)(p + offsetofWeak (s));
+    if (isObjptr (weak->objptr)) {
+      weak->link = w->weaks;
+      w->weaks = weak;
+    }
+  }
+  foreachObjptrInObject (s, p, markObjptrParallel, TRUE);
+}
+
+/* Like drainWorkParallel, but with a mark stack in place of a to-space
+ * buffer.  Half of the stack is given away whenever some worker is
+ * idle and this worker's deque is empty.
+ */
+void drainMarkStackParallel (GC_state s) {
+  struct GC_worker *w;
+  struct GC_parallelState *ps;
+  struct GC_workRange r;
+
+  w = s->worker;
+  ps = w->parallel;
+  while (TRUE) {
+    while (w->markStackSize > 0) {
+      if (w->markStackSize > 1
+          and __atomic_load_n (&ps->numActive, __ATOMIC_RELAXED) < ps->numThreads
+          and isWorkDequeEmpty (&w->deque))
+        shareMarkStack (w);
+      scanObjectForParallelMark (s, w->markStack[--w->markStackSize]);
+    }
+    unless (popWorkRange (&w->deque, &r)
+            or stealWorkParallel (s, &r)
+            or waitForWorkParallel (s, &r))
+      return;
+    assert (NULL == r.end);
+    scanObjectForParallelMark (s, r.start);
+  }
+}
+
+void majorParallelMarkJob (GC_state s) {
+  if (0 == s->worker->id)
+    foreachGlobalObjptr (s, markObjptrParallel);
+  drainMarkStackParallel (s);
+}
+
+/* If the object pointer is valid, and points to an unmarked object,
+ * then clear the object pointer.
+ */
+void updateWeaksForParallelMarkCompact (GC_state s) {
+  pointer p;
+  GC_weak w;
+
+  for (w = s->weaks; w != NULL; w = w->link) {
+    assert (BOGUS_OBJPTR != w->objptr);
+
+    if (DEBUG_WEAK)
+      fprintf (stderr, "updateWeaksForParallelMarkCompact  w = "FMTPTR"  ", (uintptr_t)w);
+    p = objptrToPointer (w->objptr, s->heap.start);
+    if (isPointerMarkedParallel (s, p)) {
+      if (DEBUG_WEAK)
+        fprintf (stderr, "not cleared\n");
+    } else {
+      if (DEBUG_WEAK)
+        fprintf (stderr, "cleared\n");
+      *(getHeaderp((pointer)w - offsetofWeak (s))) = GC_WEAK_GONE_HEADER;
+      w->objptr = BOGUS_OBJPTR;
+    }
+  }
+  s->weaks = NULL;
+}
+
+/* ---------------------------------------------------------------- */
+/*                        Parallel Compact                          */
+/* ---------------------------------------------------------------- */
+
+/* nextObjectInRegion (ps, r, ip)
+ *
+ * Find the first live object of region r that starts at or after
+ * granule *ip, and set *ip to its first granule.
+ */
+bool nextObjectInRegion (struct GC_parallelState *ps, size_t r, size_t *ip) {
+  size_t end, i;
+
+  end = (r + 1) * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN);
+  for (i = *ip; i < end; i = align (i + 1, GC_MARK_MAP_BITS)) {
+    uint64_t bits;
+
+    bits = ps->startMap[i / GC_MARK_MAP_BITS]
+           & (~(uint64_t)0 << (i % GC_MARK_MAP_BITS));
+    if (0 != bits) {
+      *ip = (i - i % GC_MARK_MAP_BITS) + (size_t)__builtin_ctzll (bits);
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/* Count the live granules of each region, and, with mark-region, its
+ * live lines.
+ */
+void countRegionsJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t r, wordsPerRegion;
+
+  ps = s->worker->parallel;
+  wordsPerRegion = ps->mapWords / ps->numRegions;
+  while (claimRegion (ps, &r)) {
+    size_t live = 0;
+
+    for (size_t k = r * wordsPerRegion; k < (r + 1) * wordsPerRegion; k++)
+      live += (size_t)__builtin_popcountll (ps->liveMap[k]);
+    ps->regionOffsets[r] = live;
+    if (s->controls.markRegion)
+      ps->regionLines[r] = countLiveLines (ps, r);
+  }
+}
+
+/* Given the live granules before each region, compute the live
+ * granules before each map word.
+ */
+void computeBlockOffsetsJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t r, wordsPerRegion;
+
+  ps = s->worker->parallel;
+  wordsPerRegion = ps->mapWords / ps->numRegions;
+  while (claimRegion (ps, &r)) {
+    size_t live = ps->regionOffsets[r];
+
+    for (size_t k = r * wordsPerRegion; k < (r + 1) * wordsPerRegion; k++) {
+      ps->blockOffsets[k] = live;
+      live += (size_t)__builtin_popcountll (ps->liveMap[k]);
+    }
+  }
+}
+
+/* Returns the address that p, which points into a live object, will
+ * have once the heap is compacted.  Objects below ps->compactBase stay
+ * where they are, and the others slide down to it.
+ */
+pointer getCompactedPointer (struct GC_parallelState *ps, pointer p) {
+  size_t i, live;
+  uint64_t below;
+
+  if (p < ps->compactBase)
+    return p;
+  i = getGranuleIndex (ps, p);
+  below = ((uint64_t)1 << (i % GC_MARK_MAP_BITS)) - 1;
+  live = ps->blockOffsets[i / GC_MARK_MAP_BITS]
+         + (size_t)__builtin_popcountll (ps->liveMap[i / GC_MARK_MAP_BITS] & below);
+  return ps->compactBase + (live - ps->compactLive) * GC_MODEL_MINALIGN
+         + (p - getGranulePointer (ps, i));
+}
+
+void updateObjptrForParallelCompact (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  if (isPointerInLargeObjectSpace (s, p))
+    return;
+  *opp = pointerToObjptr (getCompactedPointer (s->worker->parallel, p),
+                          s->heap.start);
+}
+
+/* Update every object pointer to point at the compacted object.  No
+ * object has moved yet, so each worker can read any header.
+ */
+void updatePointersJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t i, r;
+
+  ps = s->worker->parallel;
+  if (0 == s->worker->id)
+    foreachGlobalObjptr (s, updateObjptrForParallelCompact);
+  while (claimRegion (ps, &r)) {
+    for (i = r * (GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN);
+         nextObjectInRegion (ps, r, &i);
+         i++)
+      foreachObjptrInObject (s,
+                             advanceToObjectData (s, getGranulePointer (ps, i)),
+                             updateObjptrForParallelCompact, FALSE);
+  }
+}
+
+void shrinkStackForParallelCompact (GC_state s, GC_stack stack,
+                                    size_t reservedNew) {
+  if (reservedNew < stack->reserved) {
+    if (DEBUG_STACKS or s->controls.messages)
+      fprintf (stderr,
+               "[GC: Shrinking stack of size %s bytes to size %s bytes, using %s bytes.]\n",
+               uintmaxToCommaString(stack->reserved),
+               uintmaxToCommaString(reservedNew),
+               uintmaxToCommaString(stack->used));
+    stack->reserved = reservedNew;
+  }
+}
+
+void waitForRegions (struct GC_parallelState *ps, size_t n) {
+  while (__atomic_load_n (&ps->doneRegions, __ATOMIC_SEQ_CST) < n)
+    sched_yield ();
+}
+
+/* Mark region r as slid, and advance doneRegions past every finished
+ * region.  Whichever of two racing workers finishes last advances
+ * doneRegions past both of them.
+ */
+void finishRegion (struct GC_parallelState *ps, size_t r) {
+  size_t n;
+
+  __atomic_store_n (&ps->regionDone[r], TRUE, __ATOMIC_SEQ_CST);
+  n = __atomic_load_n (&ps->doneRegions, __ATOMIC_SEQ_CST);
+  while (n < ps->numRegions
+         and __atomic_load_n (&ps->regionDone[n], __ATOMIC_SEQ_CST))
+    if (__atomic_compare_exchange_n (&ps->doneRegions, &n, n + 1, FALSE,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+      n++;
+}
+
+/* Slide the objects of each region down to their compacted address.
+ * Regions are claimed in address order, and an object is not moved
+ * until every region that owns an object below the end of its new
+ * location has been slid, so no live object is overwritten.
+ */
+void slideRegionsJob (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t granulesPerRegion, i, r;
+
+  ps = s->worker->parallel;
+  granulesPerRegion = GC_PARALLEL_REGION_SIZE / GC_MODEL_MINALIGN;
+  while (claimRegion (ps, &r)) {
+    i = r * granulesPerRegion;
+    while (nextObjectInRegion (ps, r, &i)) {
+      pointer front, new, p;
+      size_t copyBytes, reservedNew, size;
+      GC_objectTypeTag tag;
+
+      front = getGranulePointer (ps, i);
+      p = advanceToObjectData (s, front);
+      size = sizeofObjectForParallelCompact (s, p, &copyBytes, &reservedNew);
+      splitHeader (s, getHeader (p), &tag, NULL, NULL, NULL);
+      if (STACK_TAG == tag)
+        shrinkStackForParallelCompact (s, (GC_stack)p, reservedNew);
+      new = getCompactedPointer (ps, front);
+      assert (new <= front);
+      if (new < front) {
+        waitForRegions (ps, min (r, getGranuleIndex (ps, new + copyBytes - 1)
+                                    / granulesPerRegion + 1));
+        GC_memmove (front, new, copyBytes);
+      }
+      recordCrossMapBoundary (s, new);
+      i += size / GC_MODEL_MINALIGN;
+    }
+    finishRegion (ps, r);
+  }
+}
+
+/* ---------------------------------------------------------------- */
+/*                  Parallel Mark-compact Collection                */
+/* ---------------------------------------------------------------- */
+
+/* Hash consing relies on the serial depth-first mark.  Mark-region
+ * needs the mark maps, even with one thread.
+ */
+bool useParallelMarkCompact (GC_state s) {
+  return (useParallelGC (s) or s->controls.markRegion)
+         and not s->hashConsDuringGC;
+}
+
+/* Compact the old generation, whose live objects have been marked,
+ * with s->parallelState.numThreads GC threads, and free the mark maps.
+ * With mark-region, only the regions after the dense prefix are
+ * compacted, and the prefix is swept into holes.
+ */
+void majorParallelCompact (GC_state s) {
+  struct GC_parallelState *ps;
+  size_t live, prefix;
+
+  ps = &s->parallelState;
+  ps->nextRegion = 0;
+  runParallel (s, countRegionsJob);
+  prefix = s->controls.markRegion ? findDensePrefix (s) : 0;
+  live = 0;
+  for (size_t r = 0; r < ps->numRegions; r++) {
+    size_t n = ps->regionOffsets[r];
+
+    ps->regionOffsets[r] = live;
+    live += n;
+  }
+  ps->nextRegion = 0;
+  runParallel (s, computeBlockOffsetsJob);
+  setCompactBase (s, prefix, live);
+  ps->nextRegion = 0;
+  runParallel (s, updatePointersJob);
+  startCrossMapRebuild (s);
+  ps->nextRegion = prefix;
+  ps->doneRegions = prefix;
+  runParallel (s, slideRegionsJob);
+  s->heap.oldGenSize =
+    (size_t)(ps->compactBase + (live - ps->compactLive) * GC_MODEL_MINALIGN
+             - s->heap.start);
+  if (prefix > 0) {
+    /* Nothing below compactBase has moved, so the prefix can be swept
+     * once the slide no longer needs the live map.
+     */
+    ps->nextRegion = 0;
+    runParallel (s, sweepRegionsJob);
+    findHoles (s);
+    if (useHeapCensus (s))
+      countSweptRegionsForHeapCensus (s);
+  }
+  finishCrossMapRebuild (s);
+  freeMarkMaps (s);
+}
+
+/* Mark and compact the old generation with
+ * s->parallelState.numThreads GC threads.  Returns FALSE, having done
+ * nothing, if the mark maps cannot be allocated.
+ */
+bool majorParallelMarkCompact (GC_state s) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  unless (allocMarkMaps (s, s->heap.oldGenSize))
+    return FALSE;
+  startLargeObjectMark (s);
+  ps->markLimit = s->heap.start + s->heap.oldGenSize;
+  ps->currentStack = getStackCurrent (s);
+  ps->numActive = ps->numThreads;
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    w->bytesMarked = 0;
+    w->markStackSize = 0;
+    w->weaks = NULL;
+  }
+  runParallel (s, majorParallelMarkJob);
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    assert (isWorkDequeEmpty (&w->deque));
+    if (DEBUG_PARALLEL or s->controls.messages)
+      fprintf (stderr,
+               "[GC:\tGC thread %"PRIu32" marked %s bytes.]\n",
+               i, uintmaxToCommaString(w->bytesMarked));
+    while (w->weaks != NULL) {
+      GC_weak weak = w->weaks;
+
+      w->weaks = weak->link;
+      weak->link = s->weaks;
+      s->weaks = weak;
+    }
+  }
+  updateWeaksForParallelMarkCompact (s);
+  majorParallelCompact (s);
+  return TRUE;
+}
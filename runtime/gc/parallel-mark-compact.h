@@ -0,0 +1,67 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A parallel mark-compact records live objects in two bitmaps over
+ * the old generation, with one bit per GC_MODEL_MINALIGN bytes (a
+ * granule): the start map has a bit for the first granule of each
+ * live object and the live map has a bit for every granule of each
+ * live object.  Since the compaction slides objects, the new address
+ * of a live object is determined by the number of live granules
+ * before it, which is found with a per-word table of prefix counts
+ * and a popcount.
+ *
+ * The old generation is divided into regions of
+ * GC_PARALLEL_REGION_SIZE bytes, which are the units of work for
+ * computing the tables, updating pointers, and sliding.  A region
+ * owns the objects that start in it.
+ */
+#define GC_PARALLEL_REGION_SIZE 0x40000
+#define GC_MARK_MAP_BITS 64
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline size_t getGranuleIndex (struct GC_parallelState *ps, pointer p);
+static inline pointer getGranulePointer (struct GC_parallelState *ps, size_t i);
+static inline size_t getHeaderBytes (GC_state s, pointer p);
+static size_t sizeofObjectForParallelCompact (GC_state s, pointer p,
+                                              size_t *copyBytesp,
+                                              size_t *reservedNewp);
+
+static void setMarkRegions (GC_state s, size_t size);
+static bool allocMarkMaps (GC_state s, size_t size);
+static void freeMarkMaps (GC_state s);
+static void setLiveGranules (struct GC_parallelState *ps, size_t first, size_t last);
+static inline bool isPointerMarkedParallel (GC_state s, pointer p);
+
+static void pushMarkStack (struct GC_worker *w, pointer p);
+static void shareMarkStack (struct GC_worker *w);
+static void markObjptrParallel (GC_state s, objptr *opp);
+static void scanObjectForParallelMark (GC_state s, pointer p);
+static void drainMarkStackParallel (GC_state s);
+static void majorParallelMarkJob (GC_state s);
+static void updateWeaksForParallelMarkCompact (GC_state s);
+
+static bool nextObjectInRegion (struct GC_parallelState *ps, size_t r, size_t *ip);
+static void countRegionsJob (GC_state s);
+static void computeBlockOffsetsJob (GC_state s);
+static inline pointer getCompactedPointer (struct GC_parallelState *ps, pointer p);
+static void updateObjptrForParallelCompact (GC_state s, objptr *opp);
+static void updatePointersJob (GC_state s);
+static void shrinkStackForParallelCompact (GC_state s, GC_stack stack,
+                                           size_t reservedNew);
+static void waitForRegions (struct GC_parallelState *ps, size_t n);
+static void finishRegion (struct GC_parallelState *ps, size_t r);
+static void slideRegionsJob (GC_state s);
+
+static inline bool useParallelMarkCompact (GC_state s);
+static void majorParallelCompact (GC_state s);
+static bool majorParallelMarkCompact (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
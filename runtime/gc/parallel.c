@@ -0,0 +1,404 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                          GC Threads                              */
+/* ---------------------------------------------------------------- */
+
+bool useParallelGC (GC_state s) {
+  return s->parallelState.numThreads > 1;
+}
+
+void initParallel (GC_state s) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  ps->numThreads = s->controls.gcThreads;
+  ps->started = FALSE;
+  ps->generation = 0;
+  ps->liveMap = NULL;
+  ps->stripeStarts = NULL;
+  ps->stripeStartsLength = 0;
+  ps->threads = NULL;
+  ps->workers = NULL;
+  ps->workerStates = NULL;
+  ps->worldBatch = NULL;
+  s->worker = NULL;
+  s->cumulativeStatistics.bytesCopiedByThread = NULL;
+  /* A concurrent mark finishes, and mark-region compacts, with
+   * parallel jobs, even on one thread.
+   */
+  unless (useParallelGC (s) or useConcurrentMark (s) or s->controls.markRegion)
+    return;
+  ps->threads =
+    (pthread_t *)(calloc_safe (ps->numThreads, sizeof (pthread_t)));
+  ps->workers =
+    (struct GC_worker *)(calloc_safe (ps->numThreads, sizeof (struct GC_worker)));
+  ps->workerStates =
+    (struct GC_state *)(calloc_safe (ps->numThreads, sizeof (struct GC_state)));
+  s->cumulativeStatistics.bytesCopiedByThread =
+    (uintmax_t *)(calloc_safe (ps->numThreads, sizeof (uintmax_t)));
+  for (uint32_t i = 0; i < ps->numThreads; i++) {
+    struct GC_worker *w = &ps->workers[i];
+
+    w->id = i;
+    w->parallel = ps;
+    w->state = (0 == i) ? s : &ps->workerStates[i];
+    initWorkDeque (&w->deque);
+  }
+}
+
+void *parallelHelper (void *arg) {
+  struct GC_worker *w;
+  struct GC_parallelState *ps;
+
+  w = (struct GC_worker *)arg;
+  ps = w->parallel;
+  pthread_mutex_lock (&ps->lock);
+  while (TRUE) {
+    while (w->generation == ps->generation)
+      pthread_cond_wait (&ps->wake, &ps->lock);
+    w->generation = ps->generation;
+    pthread_mutex_unlock (&ps->lock);
+    ps->job (w->state);
+    pthread_mutex_lock (&ps->lock);
+    assert (ps->numRunning > 0);
+    if (0 == --ps->numRunning)
+      pthread_cond_signal (&ps->done);
+  }
+  return NULL;
+}
+
+/* Start the helper threads with all asynchronous signals blocked, so
+ * that they (in particular, SIGPROF for time profiling) continue to
+ * be delivered to the mutator's thread.
+ */
+void startParallelHelpers (GC_state s) {
+  struct GC_parallelState *ps;
+  sigset_t all, old;
+
+  ps = &s->parallelState;
+  if (pthread_mutex_init (&ps->lock, NULL)
+      or pthread_cond_init (&ps->wake, NULL)
+      or pthread_cond_init (&ps->done, NULL))
+    die ("Unable to initialize GC thread synchronization.");
+  sigfillset (&all);
+  sigdelset (&all, SIGBUS);
+  sigdelset (&all, SIGFPE);
+  sigdelset (&all, SIGILL);
+  sigdelset (&all, SIGSEGV);
+  pthread_sigmask (SIG_BLOCK, &all, &old);
+  for (uint32_t i = 1; i < ps->numThreads; i++) {
+    int res;
+
+    ps->workers[i].generation = ps->generation;
+    res = pthread_create (&ps->threads[i], NULL,
+                          parallelHelper, &ps->workers[i]);
+    unless (0 == res) {
+      errno = res;
+      diee ("Unable to start GC thread %"PRIu32".", i);
+    }
+  }
+  pthread_sigmask (SIG_SETMASK, &old, NULL);
+  ps->pid = getpid ();
+  ps->started = TRUE;
+  if (DEBUG_PARALLEL or s->controls.messages)
+    fprintf (stderr, "[GC: Started %s GC threads.]\n",
+             uintmaxToCommaString (ps->numThreads - 1));
+}
+
+/* runParallel (s, job)
+ *
+ * Run job on every worker, with worker 0 on the calling thread, and
+ * return once all of them are finished.  The helper threads are
+ * started on first use, and restarted in a child process after a
+ * fork, which does not inherit them.
+ */
+void runParallel (GC_state s, GC_parallelJob job) {
+  struct GC_parallelState *ps;
+
+  assert (NULL != s->parallelState.workers);
+  assert (NULL == s->worker);
+  ps = &s->parallelState;
+  unless (ps->started and ps->pid == getpid ())
+    startParallelHelpers (s);
+  for (uint32_t i = 1; i < ps->numThreads; i++) {
+    ps->workerStates[i] = *s;
+    ps->workerStates[i].worker = &ps->workers[i];
+  }
+  s->worker = &ps->workers[0];
+  pthread_mutex_lock (&ps->lock);
+  ps->job = job;
+  ps->numRunning = ps->numThreads - 1;
+  ps->generation++;
+  pthread_cond_broadcast (&ps->wake);
+  pthread_mutex_unlock (&ps->lock);
+  job (s);
+  pthread_mutex_lock (&ps->lock);
+  while (ps->numRunning > 0)
+    pthread_cond_wait (&ps->done, &ps->lock);
+  pthread_mutex_unlock (&ps->lock);
+  s->worker = NULL;
+}
+
+/* Claim the next of ps->numRegions units of work, in order. */
+bool claimRegion (struct GC_parallelState *ps, size_t *rp) {
+  *rp = __atomic_fetch_add (&ps->nextRegion, 1, __ATOMIC_RELAXED);
+  return *rp < ps->numRegions;
+}
+
+/* ---------------------------------------------------------------- */
+/*                            Fillers                               */
+/* ---------------------------------------------------------------- */
+
+/* The smallest gap that can be filled is the smallest array, which
+ * needs room for the forwarding pointer.  See
+ * updateForwardPointersForMarkCompact.
+ */
+bool isFillableGap (size_t bytes) {
+  return 0 == bytes or bytes >= GC_ARRAY_HEADER_SIZE + OBJPTR_SIZE;
+}
+
+/* Turn [front, back) into a dead Word8 vector, so that the heap
+ * remains a contiguous sequence of objects.
+ */
+void fillGap (GC_state s, pointer front, pointer back) {
+  pointer p;
+
+  assert (front <= back);
+  assert (isFillableGap ((size_t)(back - front)));
+  if (front == back)
+    return;
+  p = front;
+  *((GC_arrayCounter*)(p)) = 0;
+  p += GC_ARRAY_COUNTER_SIZE;
+  *((GC_arrayLength*)(p)) = ((size_t)(back - front)) - GC_ARRAY_HEADER_SIZE;
+  p += GC_ARRAY_LENGTH_SIZE;
+  *((GC_header*)(p)) = GC_WORD8_VECTOR_HEADER;
+  p += GC_HEADER_SIZE;
+  assert (front + sizeofObject (s, p) == back);
+}
+
+/* ---------------------------------------------------------------- */
+/*                          Work Deques                             */
+/* ---------------------------------------------------------------- */
+
+void initWorkDeque (struct GC_workDeque *d) {
+  d->bottom = 0;
+  d->capacity = 64;
+  d->ranges =
+    (struct GC_workRange *)(calloc_safe (d->capacity, sizeof (struct GC_workRange)));
+  d->top = 0;
+  if (pthread_mutex_init (&d->lock, NULL))
+    die ("Unable to initialize GC work deque.");
+}
+
+void pushWorkRange (struct GC_workDeque *d, pointer start, pointer end) {
+  assert (NULL == end or start < end);
+  pthread_mutex_lock (&d->lock);
+  if (d->bottom == d->capacity) {
+    if (d->top > 0) {
+      memmove (d->ranges, d->ranges + d->top,
+               (d->bottom - d->top) * sizeof (struct GC_workRange));
+      d->bottom -= d->top;
+      d->top = 0;
+    } else {
+      struct GC_workRange *ranges;
+
+      ranges =
+        (struct GC_workRange *)(calloc_safe (2 * d->capacity, sizeof (struct GC_workRange)));
+      memcpy (ranges, d->ranges, d->capacity * sizeof (struct GC_workRange));
+      free (d->ranges);
+      d->ranges = ranges;
+      d->capacity *= 2;
+    }
+  }
+  d->ranges[d->bottom].start = start;
+  d->ranges[d->bottom].end = end;
+  __atomic_store_n (&d->bottom, d->bottom + 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock (&d->lock);
+}
+
+bool isWorkDequeEmpty (struct GC_workDeque *d) {
+  return __atomic_load_n (&d->top, __ATOMIC_ACQUIRE)
+         >= __atomic_load_n (&d->bottom, __ATOMIC_ACQUIRE);
+}
+
+bool popWorkRange (struct GC_workDeque *d, struct GC_workRange *r) {
+  bool res;
+
+  if (isWorkDequeEmpty (d))
+    return FALSE;
+  pthread_mutex_lock (&d->lock);
+  res = d->top < d->bottom;
+  if (res) {
+    d->bottom--;
+    *r = d->ranges[d->bottom];
+    if (d->top == d->bottom)
+      d->top = d->bottom = 0;
+  }
+  pthread_mutex_unlock (&d->lock);
+  return res;
+}
+
+bool stealWorkRange (struct GC_workDeque *d, struct GC_workRange *r) {
+  bool res;
+
+  if (isWorkDequeEmpty (d))
+    return FALSE;
+  pthread_mutex_lock (&d->lock);
+  res = d->top < d->bottom;
+  if (res) {
+    *r = d->ranges[d->top];
+    d->top++;
+  }
+  pthread_mutex_unlock (&d->lock);
+  return res;
+}
+
+/* ---------------------------------------------------------------- */
+/*                     Parallel To-space Buffers                    */
+/* ---------------------------------------------------------------- */
+
+/* Claim bytes of to-space shared by all workers. */
+pointer allocToSpaceParallel (GC_state s, size_t bytes) {
+  struct GC_parallelState *ps;
+  uintptr_t back;
+  pointer res;
+
+  ps = s->worker->parallel;
+  back = __atomic_fetch_add (&ps->toBack, (uintptr_t)bytes, __ATOMIC_RELAXED);
+  res = (pointer)back;
+  unless (res + bytes <= ps->toLimit)
+    die ("Out of memory.  Parallel GC ran out of to-space.");
+  return res;
+}
+
+/* Fill what is left of the worker's buffer, and count the filler, so
+ * that the heap census can tell it from the live Word8 vectors.
+ */
+void fillWorkerBuffer (GC_state s, struct GC_worker *w) {
+  if (w->back < w->limit) {
+    w->bytesFilled += (uintmax_t)(w->limit - w->back);
+    w->numFills++;
+  }
+  fillGap (s, w->back, w->limit);
+}
+
+/* Publish the gray part of the worker's buffer, fill the rest, and
+ * start a new buffer.
+ */
+void retireWorkerBuffer (GC_state s, struct GC_worker *w) {
+  pointer start;
+
+  if (w->scan < w->back)
+    pushWorkRange (&w->deque, w->scan, w->back);
+  fillWorkerBuffer (s, w);
+  start = allocToSpaceParallel (s, GC_PARALLEL_BUFFER_SIZE);
+  w->back = start;
+  w->limit = start + GC_PARALLEL_BUFFER_SIZE;
+  w->scan = start;
+}
+
+/* Find an object boundary near the middle of [front, back). */
+pointer splitWorkRange (GC_state s, pointer front, pointer back) {
+  pointer mid;
+
+  mid = front;
+  while ((size_t)(mid - front) < (size_t)(back - mid))
+    mid += sizeofObject (s, advanceToObjectData (s, mid));
+  assert (mid <= back);
+  return mid;
+}
+
+bool stealWorkParallel (GC_state s, struct GC_workRange *r) {
+  struct GC_parallelState *ps;
+  uint32_t id;
+
+  ps = s->worker->parallel;
+  id = s->worker->id;
+  for (uint32_t i = 1; i < ps->numThreads; i++)
+    if (stealWorkRange (&ps->workers[(id + i) % ps->numThreads].deque, r))
+      return TRUE;
+  return FALSE;
+}
+
+bool isWorkAvailableParallel (GC_state s) {
+  struct GC_parallelState *ps;
+
+  ps = s->worker->parallel;
+  for (uint32_t i = 0; i < ps->numThreads; i++)
+    unless (isWorkDequeEmpty (&ps->workers[i].deque))
+      return TRUE;
+  return FALSE;
+}
+
+/* waitForWorkParallel (s, r)
+ *
+ * Wait for another worker to publish work, and steal it into r.  A
+ * waiting worker is not counted in numActive; since only an active
+ * worker can create work, and a thief re-increments numActive before
+ * it steals, numActive reaching zero means that all work is done, in
+ * which case waitForWorkParallel returns FALSE.
+ */
+bool waitForWorkParallel (GC_state s, struct GC_workRange *r) {
+  struct GC_parallelState *ps;
+
+  ps = s->worker->parallel;
+  __atomic_fetch_sub (&ps->numActive, 1, __ATOMIC_ACQ_REL);
+  while (TRUE) {
+    if (0 == __atomic_load_n (&ps->numActive, __ATOMIC_ACQUIRE))
+      return FALSE;
+    if (isWorkAvailableParallel (s)) {
+      __atomic_fetch_add (&ps->numActive, 1, __ATOMIC_ACQ_REL);
+      if (stealWorkParallel (s, r))
+        return TRUE;
+      __atomic_fetch_sub (&ps->numActive, 1, __ATOMIC_ACQ_REL);
+    }
+    sched_yield ();
+  }
+}
+
+/* drainWorkParallel (s, f)
+ *
+ * Apply f to every object pointer in gray objects until no worker
+ * has any gray objects left.  Each worker first scans its own buffer,
+ * then its own deque, and then steals from the others.
+ */
+void drainWorkParallel (GC_state s, GC_foreachObjptrFun f) {
+  struct GC_worker *w;
+  struct GC_parallelState *ps;
+  struct GC_workRange r;
+  pointer front, back;
+
+  w = s->worker;
+  ps = w->parallel;
+  while (TRUE) {
+    if (w->scan < w->back) {
+      front = w->scan;
+      back = w->back;
+      w->scan = back;
+      /* If others are idle, give them half of our gray objects. */
+      if (__atomic_load_n (&ps->numActive, __ATOMIC_RELAXED) < ps->numThreads
+          and (size_t)(back - front) >= GC_PARALLEL_BUFFER_SIZE / GC_PARALLEL_LARGE_RATIO) {
+        pointer mid;
+
+        mid = splitWorkRange (s, front, back);
+        if (mid < back) {
+          pushWorkRange (&w->deque, mid, back);
+          back = mid;
+        }
+      }
+      foreachObjptrInRange (s, front, &back, f, TRUE);
+      continue;
+    }
+    unless (popWorkRange (&w->deque, &r)
+            or stealWorkParallel (s, &r)
+            or waitForWorkParallel (s, &r))
+      return;
+    foreachObjptrInRange (s, r.start, &r.end, f, TRUE);
+  }
+}
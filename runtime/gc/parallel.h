@@ -0,0 +1,144 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A range of to-space objects that have been copied but whose object
+ * pointers have not yet been forwarded.  Parallel marking uses a
+ * range with a NULL end for the single gray object at start.
+ */
+struct GC_workRange {
+  pointer start;
+  pointer end;
+};
+
+/* A work-stealing deque of gray ranges.  The owning worker pushes and
+ * pops at the bottom; idle workers steal from the top.  Ranges are
+ * coarse (a to-space buffer or a large object), so a lock per deque
+ * is cheap relative to the work it protects.
+ */
+struct GC_workDeque {
+  size_t bottom;
+  size_t capacity;
+  pthread_mutex_t lock;
+  struct GC_workRange *ranges;
+  size_t top;
+};
+
+/* One GC thread.  Worker 0 runs on the mutator's thread and uses the
+ * mutator's GC_state; the others run on helper threads, each with a
+ * private copy of the GC_state, so that functions written against a
+ * GC_state (foreachObjptrInRange, forwardObjptr, ...) work unchanged.
+ * A GC_state belongs to a worker iff its worker field is non-NULL.
+ */
+struct GC_worker {
+  pointer back; /* Allocation point in this worker's to-space buffer. */
+  uintmax_t bytesCopied; /* Bytes copied by this worker in this GC. */
+  uintmax_t bytesMarked; /* Bytes marked by this worker in this GC. */
+  uintmax_t bytesFilled; /* Bytes of the buffer tails this worker filled in this GC. */
+  uintmax_t bytesScanned; /* Bytes scanned for marked cards in this GC. */
+  struct GC_workDeque deque;
+  uint32_t generation; /* Last job started by this worker. */
+  uint32_t id;
+  pointer limit; /* End of this worker's to-space buffer. */
+  pointer *markStack; /* Gray objects of a parallel mark. */
+  size_t markStackCapacity;
+  size_t markStackSize;
+  uintmax_t numCardsMarked; /* Marked cards found in this GC. */
+  uintmax_t numFills; /* Buffer tails this worker filled in this GC. */
+  struct GC_parallelState *parallel;
+  pointer scan; /* Gray objects in the buffer are in [scan, back). */
+  GC_state state;
+  GC_weak weaks; /* Weaks copied or marked by this worker in this GC. */
+};
+
+typedef void (*GC_parallelJob) (GC_state s);
+
+struct GC_parallelState {
+  /* Fields used by a running parallel collection. */
+  GC_stack currentStack; /* From-space address of the current stack. */
+  size_t nextRegion; /* Next region or card stripe to be claimed. */
+  uint32_t numActive; /* Workers that may still produce work. */
+  size_t numRegions;
+  uintptr_t toBack; /* Shared to-space frontier, bumped atomically. */
+  pointer toLimit;
+  /* Fields used by a running parallel mark-compact collection. */
+  size_t *blockOffsets; /* Live granules before each map word. */
+  pointer compactBase; /* Objects below compactBase are not moved. */
+  size_t compactLive; /* Live granules below compactBase. */
+  size_t doneRegions; /* Regions [0, doneRegions) have been slid. */
+  uint64_t *liveMap; /* One bit per granule of a live object. */
+  size_t mapBytes;
+  size_t mapWords;
+  pointer markBase; /* Address of granule 0. */
+  pointer markLimit; /* Objects in [markBase, markLimit) are marked. */
+  bool *regionDone;
+  size_t *regionLines; /* Lines of each region with live granules. */
+  size_t *regionOffsets; /* Live granules before each region. */
+  uint64_t *startMap; /* One bit per live object, at its first granule. */
+  /* Fields used by a running parallel minor collection. */
+  pointer *stripeStarts; /* First object owned by each card stripe. */
+  size_t stripeStartsLength;
+  /* Fields used while a world is saved or loaded. */
+  struct GC_worldBatch *worldBatch;
+  /* The helper threads. */
+  pthread_cond_t done;
+  uint32_t generation; /* Incremented to start each job. */
+  GC_parallelJob job;
+  pthread_mutex_t lock;
+  uint32_t numRunning; /* Helpers still running the current job. */
+  uint32_t numThreads; /* Including the mutator's thread. */
+  pid_t pid; /* Process that started the helpers; see runParallel. */
+  bool started;
+  pthread_t *threads;
+  pthread_cond_t wake;
+  struct GC_worker *workers;
+  struct GC_state *workerStates;
+};
+
+/* Size of the to-space buffer handed to a worker at a time.  Objects
+ * larger than GC_PARALLEL_BUFFER_SIZE / GC_PARALLEL_LARGE_RATIO are
+ * copied into space of their own, which bounds the space wasted at
+ * the end of each buffer.
+ */
+#define GC_PARALLEL_BUFFER_SIZE 0x10000
+#define GC_PARALLEL_LARGE_RATIO 64
+
+/* Number of cards in each stripe of the card map scanned by a minor
+ * GC.  Stripes are claimed by workers in order.
+ */
+#define GC_PARALLEL_STRIPE_CARDS 1024
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline bool useParallelGC (GC_state s);
+static void initParallel (GC_state s);
+static void *parallelHelper (void *arg);
+static void startParallelHelpers (GC_state s);
+static void runParallel (GC_state s, GC_parallelJob job);
+static bool claimRegion (struct GC_parallelState *ps, size_t *rp);
+
+static inline void fillGap (GC_state s, pointer front, pointer back);
+static inline bool isFillableGap (size_t bytes);
+
+static void initWorkDeque (struct GC_workDeque *d);
+static void pushWorkRange (struct GC_workDeque *d, pointer start, pointer end);
+static inline bool isWorkDequeEmpty (struct GC_workDeque *d);
+static bool popWorkRange (struct GC_workDeque *d, struct GC_workRange *r);
+static bool stealWorkRange (struct GC_workDeque *d, struct GC_workRange *r);
+
+static pointer allocToSpaceParallel (GC_state s, size_t bytes);
+static void fillWorkerBuffer (GC_state s, struct GC_worker *w);
+static void retireWorkerBuffer (GC_state s, struct GC_worker *w);
+static pointer splitWorkRange (GC_state s, pointer front, pointer back);
+static bool stealWorkParallel (GC_state s, struct GC_workRange *r);
+static bool isWorkAvailableParallel (GC_state s);
+static bool waitForWorkParallel (GC_state s, struct GC_workRange *r);
+static void drainWorkParallel (GC_state s, GC_foreachObjptrFun f);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
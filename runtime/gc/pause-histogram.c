@@ -0,0 +1,90 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+uint32_t pauseHistogramIndex (uintmax_t pauseTime) {
+  uint32_t i;
+  uint32_t shift;
+
+  if (pauseTime < GC_PAUSE_HISTOGRAM_SUB_BUCKETS)
+    return (uint32_t)pauseTime;
+  shift = (uint32_t)(63 - __builtin_clzll ((unsigned long long)pauseTime))
+          - GC_PAUSE_HISTOGRAM_SUB_BITS;
+  i = ((shift + 1) << GC_PAUSE_HISTOGRAM_SUB_BITS)
+      + (uint32_t)(pauseTime >> shift) - GC_PAUSE_HISTOGRAM_SUB_BUCKETS;
+  return min (i, (uint32_t)GC_PAUSE_HISTOGRAM_BUCKETS - 1);
+}
+
+/* pauseHistogramValue (i)
+ *
+ * returns the longest pause counted in bucket i.
+ */
+uintmax_t pauseHistogramValue (uint32_t i) {
+  uint32_t shift;
+  uintmax_t sub;
+
+  if (i < 2 * GC_PAUSE_HISTOGRAM_SUB_BUCKETS)
+    return i;
+  shift = (i >> GC_PAUSE_HISTOGRAM_SUB_BITS) - 1;
+  sub = (i & (GC_PAUSE_HISTOGRAM_SUB_BUCKETS - 1)) + GC_PAUSE_HISTOGRAM_SUB_BUCKETS;
+  return ((sub + 1) << shift) - 1;
+}
+
+void recordPause (GC_state s, GC_pauseKind kind, uintmax_t pauseTime) {
+  struct GC_pauseHistogram *h;
+
+  h = &s->cumulativeStatistics.pauses[kind];
+  h->counts[pauseHistogramIndex (pauseTime)]++;
+  h->max = max (h->max, pauseTime);
+  h->num++;
+  h->total += pauseTime;
+}
+
+/* pauseHistogramPercentile (h, p)
+ *
+ * returns the pause, in microseconds, that p percent of the pauses
+ * counted in h did not exceed.
+ */
+uintmax_t pauseHistogramPercentile (struct GC_pauseHistogram *h, double p) {
+  uintmax_t count;
+  double r;
+  uintmax_t rank;
+
+  if (0 == h->num)
+    return 0;
+  p = max (0.0, min (p, 100.0));
+  r = ceil (p / 100.0 * (double)h->num);
+  rank = (uintmax_t)r;
+  rank = max (rank, (uintmax_t)1);
+  count = 0;
+  for (uint32_t i = 0; i < GC_PAUSE_HISTOGRAM_BUCKETS; i++) {
+    count += h->counts[i];
+    if (count >= rank)
+      return min (pauseHistogramValue (i), h->max);
+  }
+  return h->max;
+}
+
+struct GC_pauseHistogram *getPauseHistogram (GC_state s, uint32_t kind) {
+  unless (kind < GC_PAUSE_KINDS)
+    die ("Invalid pause kind %"PRIu32".", kind);
+  return &s->cumulativeStatistics.pauses[kind];
+}
+
+uintmax_t GC_getPauseHistogramNum (GC_state s, uint32_t kind) {
+  return getPauseHistogram (s, kind)->num;
+}
+
+uintmax_t GC_getPauseHistogramMax (GC_state s, uint32_t kind) {
+  return getPauseHistogram (s, kind)->max;
+}
+
+uintmax_t GC_getPauseHistogramTotal (GC_state s, uint32_t kind) {
+  return getPauseHistogram (s, kind)->total;
+}
+
+uintmax_t GC_getPauseHistogramPercentile (GC_state s, uint32_t kind, double p) {
+  return pauseHistogramPercentile (getPauseHistogram (s, kind), p);
+}
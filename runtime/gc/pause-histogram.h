@@ -0,0 +1,64 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* The pause of each collection is timed with the monotonic clock, in
+ * microseconds, and counted in the GC_pauseHistogram of its kind: a
+ * collection that did a major GC is a copying or a mark-compact pause,
+ * and any other, as well as a slice of an incremental mark between
+ * collections, is a minor pause.
+ *
+ * The histograms are log-linear, as HDR histograms are: pauses below
+ * GC_PAUSE_HISTOGRAM_SUB_BUCKETS microseconds are counted exactly,
+ * and each power of two above is split into
+ * GC_PAUSE_HISTOGRAM_SUB_BUCKETS buckets, so that a percentile is
+ * reported to within 1 / GC_PAUSE_HISTOGRAM_SUB_BUCKETS of the pause.
+ * Pauses of 2^GC_PAUSE_HISTOGRAM_MAX_BITS microseconds, some twelve
+ * days, or more are counted in the last bucket.
+ */
+#define GC_PAUSE_HISTOGRAM_SUB_BITS 5
+#define GC_PAUSE_HISTOGRAM_SUB_BUCKETS (1 << GC_PAUSE_HISTOGRAM_SUB_BITS)
+#define GC_PAUSE_HISTOGRAM_MAX_BITS 40
+#define GC_PAUSE_HISTOGRAM_BUCKETS \
+  ((GC_PAUSE_HISTOGRAM_MAX_BITS - GC_PAUSE_HISTOGRAM_SUB_BITS + 1) \
+   << GC_PAUSE_HISTOGRAM_SUB_BITS)
+
+typedef enum {
+  GC_PAUSE_MINOR,
+  GC_PAUSE_COPYING,
+  GC_PAUSE_MARK_COMPACT,
+} GC_pauseKind;
+
+#define GC_PAUSE_KINDS 3
+
+struct GC_pauseHistogram {
+  uintmax_t counts[GC_PAUSE_HISTOGRAM_BUCKETS];
+  uintmax_t max;
+  uintmax_t num;
+  uintmax_t total;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline uint32_t pauseHistogramIndex (uintmax_t pauseTime);
+static inline uintmax_t pauseHistogramValue (uint32_t i);
+static void recordPause (GC_state s, GC_pauseKind kind, uintmax_t pauseTime);
+static uintmax_t pauseHistogramPercentile (struct GC_pauseHistogram *h, double p);
+static inline struct GC_pauseHistogram *getPauseHistogram (GC_state s, uint32_t kind);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
+
+#if (defined (MLTON_GC_INTERNAL_BASIS))
+
+PRIVATE uintmax_t GC_getPauseHistogramNum (GC_state s, uint32_t kind);
+PRIVATE uintmax_t GC_getPauseHistogramMax (GC_state s, uint32_t kind);
+PRIVATE uintmax_t GC_getPauseHistogramTotal (GC_state s, uint32_t kind);
+PRIVATE uintmax_t GC_getPauseHistogramPercentile (GC_state s, uint32_t kind, double p);
+
+#endif /* (defined (MLTON_GC_INTERNAL_BASIS)) */
@@ -175,6 +175,8 @@ void incForProfiling (GC_state s, size_t amount, GC_sourceSeqIndex sourceSeqInde
     fprintf (stderr, "bumping %s by %"PRIuMAX"\n",
              getSourceName (s, topSourceIndex), (uintmax_t)amount);
   }
+  if (NULL != s->profiling.data->countSeq)
+    s->profiling.data->countSeq[sourceSeqIndex] += amount;
   s->profiling.data->countTop[topSourceIndex] += amount;
   s->profiling.data->countTop[sourceIndexToProfileMasterIndex (s, topSourceIndex)] += amount;
   if (s->profiling.stack)
@@ -213,6 +215,11 @@ GC_profileData profileMalloc (GC_state s) {
   p->totalGC = 0;
   profileMasterLength = s->sourceMaps.sourcesLength + s->sourceMaps.sourceNamesLength;
   p->countTop = (uintmax_t*)(calloc_safe(profileMasterLength, sizeof(*(p->countTop))));
+  if (GC_PROFILE_FORMAT_COLLAPSED == s->controls.profileFormat)
+    p->countSeq =
+      (uintmax_t*)(calloc_safe(s->sourceMaps.sourceSeqsLength, sizeof(*(p->countSeq))));
+  else
+    p->countSeq = NULL;
   if (s->profiling.stack)
     p->stack =
       (struct GC_profileStack *)
@@ -229,6 +236,7 @@ GC_profileData GC_profileMalloc (GC_state s) {
 void profileFree (GC_state s, GC_profileData p) {
   if (DEBUG_PROFILE)
     fprintf (stderr, "profileFree ("FMTPTR")\n", (uintptr_t)p);
+  free (p->countSeq);
   free (p->countTop);
   if (s->profiling.stack)
     free (p->stack);
@@ -239,10 +247,10 @@ void GC_profileFree (GC_state s, GC_profileData p) {
   profileFree (s, p);
 }
 
-void writeProfileCount (GC_state s, FILE *f,
-                        GC_profileData p, GC_profileMasterIndex i) {
+void writeProfileCount (FILE *f, GC_profileData p, GC_profileMasterIndex i,
+                        bool stack) {
   writeUintmaxU (f, p->countTop[i]);
-  if (s->profiling.stack) {
+  if (stack) {
     GC_profileStack ps;
 
     ps = &(p->stack[i]);
@@ -254,14 +262,101 @@ void writeProfileCount (GC_state s, FILE *f,
   writeNewline (f);
 }
 
-void profileWrite (GC_state s, GC_profileData p, const char *fileName) {
+/* writeProfile (s, fileName, p, kind, stack)
+ *
+ * writes the counts p, of kind, with stack information if stack, as
+ * an mlmon.out file.
+ */
+void writeProfile (GC_state s, const char *fileName, GC_profileData p,
+                   const char *kind, bool stack) {
   FILE *f;
+
+  f = fopen_safe (fileName, "wb");
+  writeString (f, "MLton prof\n");
+  writeString (f, kind);
+  writeString (f, stack ? "stack\n" : "current\n");
+  writeUint32X (f, s->magic);
+  writeNewline (f);
+  writeUintmaxU (f, p->total);
+  writeString (f, " ");
+  writeUintmaxU (f, p->totalGC);
+  writeNewline (f);
+  writeUint32U (f, s->sourceMaps.sourcesLength);
+  writeNewline (f);
+  for (GC_sourceIndex i = 0; i < s->sourceMaps.sourcesLength; i++)
+    writeProfileCount (f, p, (GC_profileMasterIndex)i, stack);
+  writeUint32U (f, s->sourceMaps.sourceNamesLength);
+  writeNewline (f);
+  for (GC_sourceNameIndex i = 0; i < s->sourceMaps.sourceNamesLength; i++)
+    writeProfileCount (f, p,
+                       (GC_profileMasterIndex)(i + s->sourceMaps.sourcesLength),
+                       stack);
+  fclose_safe (f);
+}
+
+/* writeCollapsedName (f, name, first)
+ *
+ * writes name as a frame of a collapsed stack, after a ';' unless it
+ * is the first.  Any ';' in name would split the frame, and is
+ * written as ','.
+ */
+void writeCollapsedName (FILE *f, const char *name, bool *first) {
+  unless (*first)
+    writeChar (f, ';');
+  *first = FALSE;
+  for (const char *c = name; '\0' != *c; c++)
+    writeChar (f, (';' == *c or '\n' == *c) ? ',' : *c);
+}
+
+/* writeCollapsedSourceSeq (s, f, i, first)
+ *
+ * writes the sources of sequence i, outermost first, and returns
+ * whether there were any.
+ */
+bool writeCollapsedSourceSeq (GC_state s, FILE *f, GC_sourceSeqIndex i,
+                              bool *first) {
+  uint32_t *sourceSeq;
+
+  sourceSeq = s->sourceMaps.sourceSeqs[i];
+  for (uint32_t j = 1; j <= sourceSeq[0]; j++)
+    writeCollapsedName (f, getSourceName (s, sourceSeq[j]), first);
+  return sourceSeq[0] > 0;
+}
+
+/* writeCollapsedProfile (s, fileName, p)
+ *
+ * writes the counts p one line for each sequence of sources with its
+ * outermost source first, followed by a space and its count.  A
+ * sequence is only what was inlined at the tick, not its call stack.
+ */
+void writeCollapsedProfile (GC_state s, const char *fileName, GC_profileData p) {
+  FILE *f;
+
+  f = fopen_safe (fileName, "wb");
+  for (GC_sourceSeqIndex i = 0; i < s->sourceMaps.sourceSeqsLength; i++) {
+    bool first;
+
+    if (0 == p->countSeq[i])
+      continue;
+    first = TRUE;
+    unless (writeCollapsedSourceSeq (s, f, i, &first))
+      writeCollapsedName (f, getSourceName (s, SOURCES_INDEX_UNKNOWN), &first);
+    writeChar (f, ' ');
+    writeUintmaxU (f, p->countSeq[i]);
+    writeNewline (f);
+  }
+  fclose_safe (f);
+}
+
+void profileWrite (GC_state s, GC_profileData p, const char *fileName) {
   const char* kind;
 
   if (DEBUG_PROFILE)
     fprintf (stderr, "profileWrite("FMTPTR",%s)\n", (uintptr_t)p, fileName);
-  f = fopen_safe (fileName, "wb");
-  writeString (f, "MLton prof\n");
+  if (NULL != p->countSeq) {
+    writeCollapsedProfile (s, fileName, p);
+    return;
+  }
   switch (s->profiling.kind) {
   case PROFILE_ALLOC:
     kind = "alloc\n";
@@ -282,25 +377,7 @@ void profileWrite (GC_state s, GC_profileData p, const char *fileName) {
     kind = "";
     assert (FALSE);
   }
-  writeString (f, kind);
-  writeString (f, s->profiling.stack ? "stack\n" : "current\n");
-  writeUint32X (f, s->magic);
-  writeNewline (f);
-  writeUintmaxU (f, p->total);
-  writeString (f, " ");
-  writeUintmaxU (f, p->totalGC);
-  writeNewline (f);
-  writeUint32U (f, s->sourceMaps.sourcesLength);
-  writeNewline (f);
-  for (GC_sourceIndex i = 0; i < s->sourceMaps.sourcesLength; i++)
-    writeProfileCount (s, f, p,
-                       (GC_profileMasterIndex)i);
-  writeUint32U (f, s->sourceMaps.sourceNamesLength);
-  writeNewline (f);
-  for (GC_sourceNameIndex i = 0; i < s->sourceMaps.sourceNamesLength; i++)
-    writeProfileCount (s, f, p,
-                       (GC_profileMasterIndex)(i + s->sourceMaps.sourcesLength));
-  fclose_safe (f);
+  writeProfile (s, fileName, p, kind, s->profiling.stack);
 }
 
 void GC_profileWrite (GC_state s, GC_profileData p, NullString8_t fileName) {
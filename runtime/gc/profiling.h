@@ -51,6 +51,12 @@ typedef uint32_t GC_profileMasterIndex;
  * functions, and the next sourceNamesLength entries are for the master versions.
  */
 typedef struct GC_profileData {
+  /* countSeq is an array of length sourceSeqsLength that counts for
+   * each sequence of sources the number of ticks that occurred in it.
+   * It is only used with profile-format collapsed, and is otherwise
+   * NULL.
+   */
+  uintmax_t *countSeq;
   /* countTop is an array that counts for each function the number of
    * ticks that occurred while the function was on top of the stack.
    */
@@ -98,7 +104,14 @@ static inline void incForProfiling (GC_state s, size_t amount, GC_sourceSeqIndex
 
 static inline char* profileIndexSourceName (GC_state s, GC_sourceIndex i);
 
-static void writeProfileCount (GC_state s, FILE *f, GC_profileData p, GC_profileMasterIndex i);
+static void writeProfileCount (FILE *f, GC_profileData p, GC_profileMasterIndex i,
+                               bool stack);
+static void writeProfile (GC_state s, const char *fileName, GC_profileData p,
+                          const char *kind, bool stack);
+static void writeCollapsedName (FILE *f, const char *name, bool *first);
+static bool writeCollapsedSourceSeq (GC_state s, FILE *f, GC_sourceSeqIndex i,
+                                     bool *first);
+static void writeCollapsedProfile (GC_state s, const char *fileName, GC_profileData p);
 
 PRIVATE GC_profileData profileMalloc (GC_state s);
 PRIVATE void profileWrite (GC_state s, GC_profileData p, const char* fileName);
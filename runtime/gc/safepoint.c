@@ -0,0 +1,32 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+bool isSafepointRequested (GC_state s) {
+  return 0 != __atomic_load_n (&s->safepointRequests, __ATOMIC_ACQUIRE);
+}
+
+void requestSafepoint (GC_state s, GC_safepointRequest r) {
+  __atomic_fetch_or (&s->safepointRequests, (uint32_t)r, __ATOMIC_RELEASE);
+  if (0 == __atomic_load_n (&s->atomicState, __ATOMIC_ACQUIRE))
+    __atomic_store_n (&s->limit, NULL, __ATOMIC_RELEASE);
+}
+
+void clearSafepointRequest (GC_state s, GC_safepointRequest r) {
+  __atomic_fetch_and (&s->safepointRequests, ~(uint32_t)r, __ATOMIC_RELAXED);
+}
+
+void serveSafepoint (GC_state s) {
+  uint32_t requests;
+
+  requests = __atomic_exchange_n (&s->safepointRequests, 0, __ATOMIC_ACQUIRE);
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr, "[GC: Safepoint for requests 0x%"PRIx32".]\n", requests);
+  /* The major GC of a heap dump also finishes a concurrent mark. */
+  if (requests & GC_SAFEPOINT_HEAP_DUMP)
+    dumpHeapAtSafepoint (s);
+  else if ((requests & GC_SAFEPOINT_REMARK) and isConcurrentMarkDone (s))
+    performGC (s, 0, getThreadCurrent(s)->bytesNeeded, FALSE, TRUE);
+}
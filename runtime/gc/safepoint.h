@@ -0,0 +1,50 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A thread of the runtime other than the mutator's, such as the
+ * background thread of a concurrent mark, or a signal handler of the
+ * runtime, such as that of heap-dump-signal, stops the mutator at a
+ * safepoint by setting a request bit in s->safepointRequests and, as
+ * GC_handler does for a signal, zeroing s->limit, so that the
+ * mutator's next limit check fails and it enters the runtime, where
+ * GC_collect serves the requests.
+ *
+ * The limit is only zeroed while the mutator is outside of the
+ * runtime and of critical sections.  A request that arrives while it
+ * is inside the runtime zeroes the limit when it leaves; see
+ * endAtomic.  One that arrives during a critical section of the
+ * program enters the runtime when the section ends, since the
+ * compiler's Thread_atomicEnd tests s->safepointRequests as well as
+ * signalIsPending.
+ *
+ * requestSafepoint tests s->atomicState and then stores to s->limit,
+ * while the mutator writes both without synchronization.  The race is
+ * benign.  The mutator only writes the limit with atomicState > 0,
+ * and each such write is followed by endAtomic, or by the test in
+ * Thread_atomicEnd, which sees the request bit, since it is set
+ * before atomicState is read.  A zero stored in the runtime, after
+ * the mutator entered it, only costs another entry.  The one request
+ * that can be missed, because the mutator's test of the request bits
+ * is not ordered after its decrement of atomicState, waits for the
+ * next entry to the runtime, at the latest when the nursery fills.
+ */
+typedef enum {
+  GC_SAFEPOINT_REMARK = 1 << 0, /* A concurrent mark is ready to finish. */
+  GC_SAFEPOINT_HEAP_DUMP = 1 << 1, /* heap-dump-signal arrived. */
+} GC_safepointRequest;
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static inline bool isSafepointRequested (GC_state s);
+static void requestSafepoint (GC_state s, GC_safepointRequest r);
+static inline void clearSafepointRequest (GC_state s, GC_safepointRequest r);
+static void serveSafepoint (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -13,6 +13,8 @@ void GC_share (GC_state s, pointer object) {
   enter (s); /* update stack in heap, in case it is reached */
   if (DEBUG_SHARE)
     fprintf (stderr, "GC_share "FMTPTR"\n", (uintptr_t)object);
+  /* Hash consing changes objects without marking cards. */
+  cancelConcurrentMark (s);
   if (DEBUG_SHARE or s->controls.messages)
     s->lastMajorStatistics.bytesHashConsed = 0;
   // Don't hash cons during the first round of marking.
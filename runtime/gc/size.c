@@ -10,6 +10,9 @@ size_t GC_size (GC_state s, pointer root) {
   size_t res;
   
   enter (s); /* update stack in heap, in case it is reached */
+  /* The depth-first mark reverses pointers as it goes. */
+  if (isConcurrentMarkActive (s))
+    waitForConcurrentMarker (s);
   if (DEBUG_SIZE)
     fprintf (stderr, "GC_size marking\n");
   res = dfsMarkByMode (s, root, MARK_MODE, FALSE, FALSE);
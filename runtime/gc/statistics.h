@@ -11,8 +11,13 @@
 struct GC_cumulativeStatistics {
   uintmax_t bytesAllocated;
   uintmax_t bytesCopied;
+  uintmax_t *bytesCopiedByThread; /* Per GC thread; NULL unless gc-threads > 1. */
   uintmax_t bytesCopiedMinor;
+  uintmax_t bytesCopiedToHoles; /* Bytes promoted into holes; see mark-region.h. */
+  uintmax_t bytesCopiedToSurvivors; /* See survivor.h. */
+  uintmax_t bytesDiscarded; /* Given back with heap-release or reserve-heap. */
   uintmax_t bytesHashConsed;
+  uintmax_t bytesLargeObjects; /* Bytes mapped for large objects; see large-object.h. */
   uintmax_t bytesMarkCompacted;
   uintmax_t bytesScannedMinor;
 
@@ -23,12 +28,18 @@ struct GC_cumulativeStatistics {
 
   uintmax_t numCardsMarked; /* Number of marked cards seen during minor GCs. */
 
+  uintmax_t numConcurrentMarks;
   uintmax_t numGCs;
   uintmax_t numCopyingGCs;
   uintmax_t numHashConsGCs;
+  uintmax_t numIncrementalMarks;
+  uintmax_t numLargeObjects;
   uintmax_t numMarkCompactGCs;
+  uintmax_t numMarkSlices; /* Slices of incremental marks. */
   uintmax_t numMinorGCs;
 
+  struct GC_pauseHistogram pauses[GC_PAUSE_KINDS]; /* See pause-histogram.h. */
+
   struct rusage ru_gc; /* total resource usage in gc. */
   struct rusage ru_gcCopying; /* resource usage in major copying gcs. */
   struct rusage ru_gcMarkCompact; /* resource usage in major mark-compact gcs. */
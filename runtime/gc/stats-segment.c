@@ -0,0 +1,110 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initStatsSegment (GC_state s) {
+  struct GC_publishedStats *ps;
+  void *res;
+
+  s->statsSegment.nurseryUsed = 0;
+  s->statsSegment.stats = NULL;
+  if (NULL == s->controls.statsSegment)
+    return;
+  if (NULL != strchr (s->controls.statsSegment, '/'))
+    die ("Invalid @MLton stats-segment: %s.", s->controls.statsSegment);
+  res = GC_mapShared (s->controls.statsSegment, sizeof (struct GC_publishedStats));
+  if ((void*)-1 == res)
+    diee ("Unable to create stats segment %s.", s->controls.statsSegment);
+  ps = (struct GC_publishedStats *)res;
+  memset (ps, 0, sizeof (*ps));
+  ps->version = GC_STATS_SEGMENT_VERSION;
+  ps->size = sizeof (*ps);
+  ps->pid = (uint64_t)getpid ();
+  __atomic_store_n (&ps->magic, GC_STATS_SEGMENT_MAGIC, __ATOMIC_RELEASE);
+  s->statsSegment.stats = ps;
+}
+
+bool useStatsSegment (GC_state s) {
+  return NULL != s->statsSegment.stats;
+}
+
+void beginStatsSegment (GC_state s) {
+  unless (useStatsSegment (s))
+    return;
+  s->statsSegment.nurseryUsed = (size_t)(s->frontier - s->heap.nursery);
+}
+
+/* updateStatsSegment (s, pauseTime)
+ *
+ * publishes the statistics at the end of a collection that paused
+ * the mutator for pauseTime microseconds.  A child that the program
+ * forks stops publishing, rather than write over its parent's
+ * statistics.
+ */
+void updateStatsSegment (GC_state s, uintmax_t pauseTime) {
+  struct GC_cumulativeStatistics *cs;
+  struct GC_publishedStats *ps;
+  struct timeval tv;
+
+  unless (useStatsSegment (s))
+    return;
+  ps = s->statsSegment.stats;
+  if ((uint64_t)getpid () != ps->pid) {
+    munmap ((void*)ps, sizeof (*ps));
+    s->statsSegment.stats = NULL;
+    return;
+  }
+  cs = &s->cumulativeStatistics;
+  gettimeofday (&tv, NULL);
+  __atomic_store_n (&ps->sequence, ps->sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+  ps->time = 1000000 * (uint64_t)tv.tv_sec + (uint64_t)tv.tv_usec;
+  ps->bytesAllocated = cs->bytesAllocated;
+  ps->bytesCopied = cs->bytesCopied;
+  ps->bytesCopiedMinor = cs->bytesCopiedMinor;
+  ps->bytesLive = s->lastMajorStatistics.bytesLive;
+  ps->bytesMarkCompacted = cs->bytesMarkCompacted;
+  ps->heapSize = s->heap.size;
+  ps->lastPauseTime = pauseTime;
+  ps->maxBytesLive = cs->maxBytesLive;
+  ps->maxPauseTime = max (ps->maxPauseTime, (uint64_t)pauseTime);
+  ps->numCopyingGCs = cs->numCopyingGCs;
+  ps->numGCs = cs->numGCs;
+  ps->numMarkCompactGCs = cs->numMarkCompactGCs;
+  ps->numMinorGCs = cs->numMinorGCs;
+  ps->nurserySize = s->heap.size - (size_t)(s->heap.nursery - s->heap.start);
+  ps->nurseryUsed = s->statsSegment.nurseryUsed;
+  ps->oldGenSize = s->heap.oldGenSize;
+  ps->totalPauseTime += pauseTime;
+  for (uint32_t k = 0; k < GC_PAUSE_KINDS; k++) {
+    struct GC_pauseHistogram *h = &cs->pauses[k];
+    struct GC_publishedPauseHistogram *p = &ps->pauses[k];
+
+    p->max = h->max;
+    p->num = h->num;
+    p->total = h->total;
+    for (uint32_t i = 0; i < GC_PAUSE_HISTOGRAM_BUCKETS; i++)
+      p->counts[i] = h->counts[i];
+  }
+  __atomic_store_n (&ps->sequence, ps->sequence + 1, __ATOMIC_RELEASE);
+}
+
+/* closeStatsSegment (s)
+ *
+ * removes the segment, unless this is a forked child, which only
+ * unmaps it, leaving its parent's in place.
+ */
+void closeStatsSegment (GC_state s) {
+  struct GC_publishedStats *ps;
+
+  unless (useStatsSegment (s))
+    return;
+  ps = s->statsSegment.stats;
+  if ((uint64_t)getpid () != ps->pid)
+    munmap ((void*)ps, sizeof (*ps));
+  else
+    GC_unmapShared (s->controls.statsSegment, (void*)ps, sizeof (*ps));
+  s->statsSegment.stats = NULL;
+}
@@ -0,0 +1,78 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With stats-segment, the statistics are published at the end of each
+ * collection in a GC_publishedStats, mapped shared from a file in
+ * /dev/shm, so that another process may read them while the program
+ * runs.  The mutator does not touch the segment.
+ *
+ * The segment is laid out as struct GC_publishedStats, whose fields
+ * are all 64 bits and only ever added at its end; a reader checks
+ * magic, and that version and size are at least those it knows.  The
+ * writer makes sequence odd while it updates the segment, so a reader
+ * copies the segment, and retries, until it reads the same even
+ * sequence before and after the copy.
+ *
+ * Version 2 replaced the 32 power-of-two pause buckets of version 1
+ * with the pause histograms of pause-histogram.h.
+ */
+#define GC_STATS_SEGMENT_MAGIC 0x4D4C544F4E475354ULL /* "MLTONGST" */
+#define GC_STATS_SEGMENT_VERSION 2
+
+/* A GC_pauseHistogram, in 64-bit words. */
+struct GC_publishedPauseHistogram {
+  uint64_t max;
+  uint64_t num;
+  uint64_t total;
+  uint64_t counts[GC_PAUSE_HISTOGRAM_BUCKETS];
+};
+
+struct GC_publishedStats {
+  uint64_t magic;
+  uint64_t version;
+  uint64_t size; /* sizeof (struct GC_publishedStats) */
+  uint64_t pid;
+  uint64_t sequence;
+  uint64_t time; /* Of the last update, in microseconds since the epoch. */
+
+  uint64_t bytesAllocated;
+  uint64_t bytesCopied;
+  uint64_t bytesCopiedMinor;
+  uint64_t bytesLive; /* At the last major GC. */
+  uint64_t bytesMarkCompacted;
+  uint64_t heapSize;
+  uint64_t lastPauseTime; /* In microseconds, as are the pause times below. */
+  uint64_t maxBytesLive;
+  uint64_t maxPauseTime;
+  uint64_t numCopyingGCs;
+  uint64_t numGCs;
+  uint64_t numMarkCompactGCs;
+  uint64_t numMinorGCs;
+  uint64_t nurserySize;
+  uint64_t nurseryUsed; /* At the start of the last GC. */
+  uint64_t oldGenSize;
+  uint64_t totalPauseTime;
+  struct GC_publishedPauseHistogram pauses[GC_PAUSE_KINDS]; /* By GC_pauseKind. */
+};
+
+struct GC_statsSegment {
+  size_t nurseryUsed; /* At the start of the current GC. */
+  struct GC_publishedStats *stats; /* NULL unless stats-segment. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initStatsSegment (GC_state s);
+static inline bool useStatsSegment (GC_state s);
+static void beginStatsSegment (GC_state s);
+static void updateStatsSegment (GC_state s, uintmax_t pauseTime);
+static void closeStatsSegment (GC_state s);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,280 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+void initSurvivorSpaces (GC_state s) {
+  struct GC_survivorSpaces *ss;
+
+  ss = &s->survivorSpaces;
+  ss->ages = NULL;
+  ss->agesSize = 0;
+  ss->back = NULL;
+  ss->cardMark = GC_SURVIVOR_CARD;
+  ss->from = NULL;
+  ss->fromLimit = NULL;
+  ss->promoteAll = FALSE;
+  ss->size = 0;
+  ss->start = NULL;
+  ss->to = NULL;
+  ss->toBack = NULL;
+  ss->toLimit = NULL;
+  ss->weaks = NULL;
+}
+
+bool useSurvivorSpaces (GC_state s) {
+  return s->controls.tenuringThreshold > 0
+         and s->mutatorMarksCards
+         and not isConcurrentMarkActive (s);
+}
+
+bool isPointerInSurvivorSpace (GC_state s, pointer p) {
+  return s->survivorSpaces.from <= p and p < s->survivorSpaces.back;
+}
+
+bool isPointerInSurvivorToSpace (GC_state s, pointer p) {
+  return s->survivorSpaces.to <= p and p < s->survivorSpaces.toBack;
+}
+
+size_t sizeofSurvivors (GC_state s) {
+  return (size_t)(s->survivorSpaces.back - s->survivorSpaces.from);
+}
+
+/* The bytes that the survivor spaces keep from the nursery and from
+ * the old generation, which must be able to absorb the survivors.
+ */
+size_t sizeofSurvivorReserve (GC_state s) {
+  if (0 == s->survivorSpaces.size)
+    return 0;
+  return 2 * s->survivorSpaces.size + sizeofSurvivors (s);
+}
+
+uint8_t *getSurvivorAgep (GC_state s, pointer p) {
+  return &s->survivorSpaces.ages[(size_t)(p - s->survivorSpaces.start)
+                                 / GC_MODEL_MINALIGN];
+}
+
+/* reserveSurvivorSpaces (s, oldGenBytesRequested)
+ *
+ * Place the survivor spaces at the end of the heap, unless they hold
+ * survivors, and return the bytes that they take from the nursery.
+ * The survivors are promoted and 0 is returned unless the rest of the
+ * free space is at least as large as what the spaces reserve.
+ */
+size_t reserveSurvivorSpaces (GC_state s, size_t oldGenBytesRequested) {
+  struct GC_survivorSpaces *ss;
+  size_t free, size;
+
+  ss = &s->survivorSpaces;
+  unless (useSurvivorSpaces (s)) {
+    releaseSurvivorSpaces (s);
+    return 0;
+  }
+  assert (s->heap.oldGenSize + oldGenBytesRequested <= s->heap.size);
+  free = s->heap.size - (s->heap.oldGenSize + oldGenBytesRequested);
+  if (0 == sizeofSurvivors (s)) {
+    size = alignDown ((size_t)((float)s->heap.size / s->controls.ratios.survivor),
+                      s->sysvals.pageSize);
+    if (size < GC_SURVIVOR_MIN_SIZE)
+      size = 0;
+    if (ss->agesSize < 2 * size / GC_MODEL_MINALIGN) {
+      if (NULL != ss->ages)
+        GC_release (ss->ages, ss->agesSize);
+      ss->agesSize = align (2 * size / GC_MODEL_MINALIGN, s->sysvals.pageSize);
+      ss->ages = GC_mmapAnon_safe (NULL, ss->agesSize);
+    }
+    ss->size = size;
+    ss->start = s->heap.start + s->heap.size - 2 * size;
+    ss->from = alignFrontier (s, ss->start);
+    ss->fromLimit = ss->start + size;
+    ss->to = alignFrontier (s, ss->fromLimit);
+    ss->toLimit = ss->fromLimit + size;
+    ss->back = ss->from;
+    ss->toBack = ss->to;
+  }
+  if (0 == ss->size or free < 2 * sizeofSurvivorReserve (s)) {
+    releaseSurvivorSpaces (s);
+    return 0;
+  }
+  return 2 * ss->size;
+}
+
+/* Promote the survivors, of which there can be some only just after a
+ * minor GC, and stop using the survivor spaces.
+ */
+void releaseSurvivorSpaces (GC_state s) {
+  if (sizeofSurvivors (s) > 0) {
+    size_t bytesPromoted;
+
+    s->forwardState.amInMinorGC = TRUE;
+    s->forwardState.toStart = s->heap.start + s->heap.oldGenSize;
+    s->forwardState.toLimit = s->heap.nursery;
+    s->forwardState.back = s->forwardState.toStart;
+    minorCheneyCopyToSurvivors (s, TRUE);
+    bytesPromoted = (size_t)(s->forwardState.back - s->forwardState.toStart);
+    s->cumulativeStatistics.bytesCopiedMinor += bytesPromoted;
+    s->heap.oldGenSize += bytesPromoted;
+    if (DEBUG_GENERATIONAL or s->controls.messages)
+      fprintf (stderr,
+               "[GC: Promoted %s bytes of survivors.]\n",
+               uintmaxToCommaString(bytesPromoted));
+  }
+  s->survivorSpaces.size = 0;
+  s->survivorSpaces.from = NULL;
+  s->survivorSpaces.back = NULL;
+}
+
+/* Like forwardObjptr, but copies an object that is young enough into
+ * the survivor to-space when it has room.
+ */
+void forwardObjptrToSurvivors (GC_state s, objptr *opp) {
+  struct GC_survivorSpaces *ss;
+  pointer p;
+  GC_header header;
+
+  ss = &s->survivorSpaces;
+  p = objptrToPointer (*opp, s->heap.start);
+  header = getHeader (p);
+  if (header != GC_FORWARDED) {
+    size_t size, skip;
+    size_t headerBytes;
+    uint8_t age;
+    pointer to;
+
+    size = sizeofObjectForForward (s, p, header, &headerBytes, &skip);
+    age = isPointerInSurvivorSpace (s, p) ? *(getSurvivorAgep (s, p)) : 0;
+    if (not ss->promoteAll
+        and age < s->controls.tenuringThreshold
+        and size + skip <= (size_t)(ss->toLimit - ss->toBack)) {
+      to = ss->toBack;
+      ss->toBack += size + skip;
+      *(getSurvivorAgep (s, to + headerBytes)) = (uint8_t)(age + 1);
+    } else {
+      to = s->forwardState.back;
+      assert (to + size + skip <= s->forwardState.toLimit);
+      s->forwardState.back += size + skip;
+    }
+    GC_memcpy (p - headerBytes, to, size);
+    linkWeakForForward (s, to + headerBytes, header, &s->weaks);
+    *((GC_header*)(p - GC_HEADER_SIZE)) = GC_FORWARDED;
+    *((objptr*)p) = pointerToObjptr (to + headerBytes, s->heap.start);
+  }
+  *opp = *((objptr*)p);
+}
+
+void forwardObjptrIfYoungToSurvivors (GC_state s, objptr *opp) {
+  pointer p;
+
+  p = objptrToPointer (*opp, s->heap.start);
+  if (p < s->heap.nursery
+      or isPointerInLargeObjectSpace (s, p)
+      or isPointerInSurvivorToSpace (s, p))
+    return;
+  assert ((s->heap.nursery <= p and p < s->frontier)
+          or isPointerInSurvivorSpace (s, p));
+  forwardObjptrToSurvivors (s, opp);
+}
+
+/* For the fields of objects in the old generation, including those
+ * promoted by this minor GC.
+ */
+void forwardOldObjptrIfYoungToSurvivors (GC_state s, objptr *opp) {
+  forwardObjptrIfYoungToSurvivors (s, opp);
+  if (isPointerInSurvivorToSpace (s, objptrToPointer (*opp, s->heap.start)))
+    *(pointerToCardMapAddr (s, (pointer)opp)) = s->survivorSpaces.cardMark;
+}
+
+/* Like updateWeaksForCheneyCopy, but keeps the weaks in the old
+ * generation whose object is now a survivor for the next minor GC.
+ */
+void updateWeaksForSurvivors (GC_state s) {
+  GC_weak kept, next, w;
+  pointer p;
+
+  kept = NULL;
+  for (w = s->weaks; w != NULL; w = next) {
+    next = w->link;
+    assert (BOGUS_OBJPTR != w->objptr);
+    p = objptrToPointer (w->objptr, s->heap.start);
+    if (GC_FORWARDED == getHeader (p)) {
+      w->objptr = *(objptr*)p;
+      if ((pointer)w < s->heap.nursery
+          and isPointerInSurvivorToSpace (s, objptrToPointer (w->objptr,
+                                                              s->heap.start))) {
+        w->link = kept;
+        kept = w;
+      }
+    } else {
+      *(getHeaderp((pointer)w - offsetofWeak (s))) = GC_WEAK_GONE_HEADER;
+      w->objptr = BOGUS_OBJPTR;
+    }
+  }
+  s->weaks = NULL;
+  s->survivorSpaces.weaks = kept;
+}
+
+/* Clear the cards that were not marked by the last minor GC. */
+void keepSurvivorCards (GC_state s) {
+  GC_cardMapElem *cardMap;
+  GC_cardMapElem mark;
+
+  cardMap = s->generationalMaps.cardMap;
+  mark = s->survivorSpaces.cardMark;
+  for (size_t i = 0; i < s->generationalMaps.cardMapLength; i++)
+    if (cardMap[i] != mark)
+      cardMap[i] = 0x0;
+}
+
+/* Copy the young survivors of the nursery and of the survivor
+ * from-space into the survivor to-space, and promote the others to
+ * the end of the old generation.  The promoted objects and the
+ * survivors are scanned in turn until there are no more.  Returns the
+ * number of bytes copied into the survivor to-space.
+ */
+size_t minorCheneyCopyToSurvivors (GC_state s, bool promoteAll) {
+  struct GC_survivorSpaces *ss;
+  pointer scan, tailScan, tmp;
+  size_t bytesCopied;
+
+  ss = &s->survivorSpaces;
+  assert (ss->size > 0);
+  ss->promoteAll = promoteAll;
+  ss->cardMark =
+    (GC_SURVIVOR_CARD == ss->cardMark) ? GC_SURVIVOR_CARD + 1 : GC_SURVIVOR_CARD;
+  ss->toBack = ss->to;
+  /* The weaks whose object may move. */
+  s->weaks = ss->weaks;
+  ss->weaks = NULL;
+  scan = ss->to;
+  tailScan = s->forwardState.toStart;
+  foreachGlobalObjptr (s, forwardObjptrIfYoungToSurvivors);
+  forwardInterGenerationalObjptrs (s, forwardOldObjptrIfYoungToSurvivors);
+  while (TRUE) {
+    if (tailScan < s->forwardState.back)
+      tailScan = foreachObjptrInRange (s, tailScan, &s->forwardState.back,
+                                       forwardOldObjptrIfYoungToSurvivors, TRUE);
+    else if (scan < ss->toBack)
+      scan = foreachObjptrInRange (s, scan, &ss->toBack,
+                                   forwardObjptrIfYoungToSurvivors, TRUE);
+    else
+      break;
+  }
+  updateWeaksForSurvivors (s);
+  bytesCopied = (size_t)(ss->toBack - ss->to);
+  s->cumulativeStatistics.bytesCopiedToSurvivors += bytesCopied;
+  tmp = ss->from;
+  ss->from = ss->to;
+  ss->to = tmp;
+  tmp = ss->fromLimit;
+  ss->fromLimit = ss->toLimit;
+  ss->toLimit = tmp;
+  ss->back = ss->toBack;
+  ss->toBack = ss->to;
+  ss->promoteAll = FALSE;
+  if (DEBUG_GENERATIONAL or s->controls.messages)
+    fprintf (stderr,
+             "[GC:\tcopied %s bytes into survivor spaces.]\n",
+             uintmaxToCommaString(bytesCopied));
+  return bytesCopied;
+}
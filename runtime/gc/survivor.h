@@ -0,0 +1,76 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With tenuring-threshold n > 0, the end of the heap holds two
+ * survivor spaces, each of 1 / survivor-ratio of the heap, and the
+ * nursery ends where they start.  A minor GC copies an object that
+ * has survived fewer than n minor GCs into the survivor space that is
+ * not in use, and promotes the others into the old generation, as
+ * usual.  The spaces then swap roles.  Since the survivor spaces are
+ * in the heap, the mutator marks cards for the pointers that it
+ * writes to them, as for the nursery.
+ *
+ * The age of each survivor is kept in a side table with a byte for
+ * each GC_MODEL_MINALIGN bytes of the spaces, indexed by where the
+ * object's data starts, because compiled code may compare headers.
+ *
+ * A minor GC marks the card of an old object's field that points to a
+ * survivor with cardMark, which alternates between GC_SURVIVOR_CARD
+ * and GC_SURVIVOR_CARD + 1, and every other card is cleared
+ * afterwards, so that the next minor GC finds the survivors that are
+ * only reachable from the old generation.  A weak in the old
+ * generation whose object is a survivor is kept on weaks until the
+ * object is promoted or dies.
+ *
+ * Minor GCs with survivor spaces are serial and do not promote into
+ * the holes of mark-region.  The survivors are promoted before a major
+ * GC or a concurrent mark, and whenever minor GCs are not used; there
+ * are no survivor spaces during a concurrent mark.
+ */
+struct GC_survivorSpaces {
+  uint8_t *ages;
+  size_t agesSize; /* Bytes mapped for ages. */
+  pointer back; /* The survivors are in [from, back). */
+  GC_cardMapElem cardMark; /* Of the last minor GC. */
+  pointer from;
+  pointer fromLimit;
+  bool promoteAll; /* During a minor GC, promote every survivor. */
+  size_t size; /* Of each space; if 0, then no survivor spaces. */
+  pointer start; /* Of the first space. */
+  pointer to;
+  pointer toBack; /* During a minor GC, the survivors copied to [to, toBack). */
+  pointer toLimit;
+  GC_weak weaks; /* Weaks in the old generation whose object is a survivor. */
+};
+
+#define GC_SURVIVOR_CARD 2
+/* Survivor spaces are not used if each would be smaller. */
+#define GC_SURVIVOR_MIN_SIZE 0x10000
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static void initSurvivorSpaces (GC_state s);
+static inline bool useSurvivorSpaces (GC_state s);
+static inline bool isPointerInSurvivorSpace (GC_state s, pointer p);
+static inline bool isPointerInSurvivorToSpace (GC_state s, pointer p);
+static inline size_t sizeofSurvivors (GC_state s);
+static inline size_t sizeofSurvivorReserve (GC_state s);
+static inline uint8_t *getSurvivorAgep (GC_state s, pointer p);
+static size_t reserveSurvivorSpaces (GC_state s, size_t oldGenBytesRequested);
+static void releaseSurvivorSpaces (GC_state s);
+
+static void forwardObjptrToSurvivors (GC_state s, objptr *opp);
+static void forwardObjptrIfYoungToSurvivors (GC_state s, objptr *opp);
+static void forwardOldObjptrIfYoungToSurvivors (GC_state s, objptr *opp);
+static void updateWeaksForSurvivors (GC_state s);
+static void keepSurvivorCards (GC_state s);
+static size_t minorCheneyCopyToSurvivors (GC_state s, bool promoteAll);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
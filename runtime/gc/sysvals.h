@@ -9,6 +9,7 @@
 #if (defined (MLTON_GC_INTERNAL_TYPES))
 
 struct GC_sysvals {
+  size_t hugePageSize; /* 0 unless huge-pages is used and supported. */
   size_t ram;
   size_t pageSize;
   uintmax_t physMem;
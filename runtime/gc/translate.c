@@ -19,6 +19,9 @@ void translateObjptr (GC_state s,
   from = s->translateState.from;
   to = s->translateState.to;
   p = objptrToPointer (*opp, from);
+  /* Large objects do not move. */
+  if (p < from or from + s->translateState.size <= p)
+    return;
   p = (p - from) + to;
   *opp = pointerToObjptr (p, to);
 }
@@ -38,9 +41,129 @@ void translateHeap (GC_state s, pointer from, pointer to, size_t size) {
              (uintptr_t)to,
              (uintptr_t)from);
   s->translateState.from = from;
+  s->translateState.size = size;
   s->translateState.to = to;
   /* Translate globals and heap. */
   foreachGlobalObjptr (s, translateObjptr);
   limit = to + size;
   foreachObjptrInRange (s, alignFrontier (s, to), &limit, translateObjptr, FALSE);
 }
+
+/* ---------------------------------------------------------------- */
+/*                        translateHeapByMap                        */
+/* ---------------------------------------------------------------- */
+
+size_t sizeofRelocationMap (size_t size) {
+  size_t words;
+
+  words = size / OBJPTR_SIZE;
+  return (words + GC_RELOCATION_MAP_BITS - 1) / GC_RELOCATION_MAP_BITS
+    * sizeof(uint64_t);
+}
+
+void setRelocationBit (GC_state s, objptr *opp) {
+  size_t i;
+
+  i = (size_t)((pointer)opp - s->translateState.from);
+  unless (isAligned (i, OBJPTR_SIZE)) {
+    s->translateState.mapComplete = FALSE;
+    return;
+  }
+  i /= OBJPTR_SIZE;
+  s->translateState.map[i / GC_RELOCATION_MAP_BITS] |=
+    (uint64_t)1 << (i % GC_RELOCATION_MAP_BITS);
+}
+
+/* buildRelocationMap (s, start, size)
+ *
+ * returns the relocation map of the old generation of size bytes at
+ * start, or NULL if it cannot be allocated or if some objptr is not
+ * aligned, in which case the heap must be translated by translateHeap.
+ */
+uint64_t *buildRelocationMap (GC_state s, pointer start, size_t size) {
+  pointer limit;
+  uint64_t *map;
+
+  if (0 == size)
+    return NULL;
+  map = calloc (1, sizeofRelocationMap (size));
+  if (NULL == map)
+    return NULL;
+  s->translateState.from = start;
+  s->translateState.map = map;
+  s->translateState.mapComplete = TRUE;
+  s->translateState.size = size;
+  limit = start + size;
+  foreachObjptrInRange (s, alignFrontier (s, start), &limit, setRelocationBit, FALSE);
+  unless (s->translateState.mapComplete) {
+    free (map);
+    map = NULL;
+  }
+  s->translateState.map = NULL;
+  return map;
+}
+
+/* translateHeapByMap (s, from, to, size, map)
+ *
+ * is translateHeap for an old generation with the relocation map map.
+ * It reads only the map and the words that hold objptrs, rather than
+ * every object, so the pages without objptrs are never touched.
+ */
+void translateHeapByMap (GC_state s, pointer from, pointer to, size_t size,
+                         const uint64_t *map) {
+  if (from == to)
+    return;
+
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr,
+             "[GC: Translating old-gen of size %s bytes of heap at "FMTPTR" from "FMTPTR" by its relocation map.]\n",
+             uintmaxToCommaString(size),
+             (uintptr_t)to,
+             (uintptr_t)from);
+  s->translateState.from = from;
+  s->translateState.size = size;
+  s->translateState.to = to;
+  foreachGlobalObjptr (s, translateObjptr);
+  translateObjptrsByMap (s, to, size, map);
+}
+
+/* translateObjptrsByMap (s, start, size, map)
+ *
+ * translates the objptrs of the old generation of size bytes at start
+ * with the relocation map map.
+ */
+void translateObjptrsByMap (GC_state s, pointer start, size_t size,
+                            const uint64_t *map) {
+  size_t words;
+
+  words = sizeofRelocationMap (size) / sizeof(uint64_t);
+  for (size_t k = 0; k < words; k++) {
+    uint64_t bits;
+
+    for (bits = map[k]; 0 != bits; bits &= bits - 1) {
+      size_t i;
+
+      i = k * GC_RELOCATION_MAP_BITS + (size_t)__builtin_ctzll (bits);
+      translateObjptr (s, (objptr*)(start + i * OBJPTR_SIZE));
+    }
+  }
+}
+
+/* rebaseHeap (s, from, to, map)
+ *
+ * translates the objptrs of the old generation, with the relocation
+ * map map, and of the globals, from from to to, as translateHeapByMap
+ * does, but leaves the old generation at s->heap.start, so that it can
+ * be saved as if it were at to.  The heap may not be used until it is
+ * rebased back.
+ */
+void rebaseHeap (GC_state s, pointer from, pointer to, const uint64_t *map) {
+  if (from == to)
+    return;
+
+  s->translateState.from = from;
+  s->translateState.size = s->heap.oldGenSize;
+  s->translateState.to = to;
+  foreachGlobalObjptr (s, translateObjptr);
+  translateObjptrsByMap (s, s->heap.start, s->heap.oldGenSize, map);
+}
@@ -10,14 +10,31 @@
 
 struct GC_translateState {
   pointer from;
+  /* The relocation map being built; see buildRelocationMap. */
+  uint64_t *map;
+  bool mapComplete;
+  size_t size;
   pointer to;
 };
 
+/* A relocation map has a bit for each OBJPTR_SIZE-aligned word of an
+ * old generation, set if the word holds an objptr.
+ */
+#define GC_RELOCATION_MAP_BITS 64
+
 #endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
 
 #if (defined (MLTON_GC_INTERNAL_FUNCS))
 
 static inline void translateObjptr (GC_state s, objptr *opp);
 static void translateHeap (GC_state s, pointer from, pointer to, size_t size);
+static inline size_t sizeofRelocationMap (size_t size);
+static void setRelocationBit (GC_state s, objptr *opp);
+static uint64_t *buildRelocationMap (GC_state s, pointer start, size_t size);
+static void translateHeapByMap (GC_state s, pointer from, pointer to, size_t size,
+                                const uint64_t *map);
+static void translateObjptrsByMap (GC_state s, pointer start, size_t size,
+                                   const uint64_t *map);
+static void rebaseHeap (GC_state s, pointer from, pointer to, const uint64_t *map);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,489 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                    Compression and checksums                     */
+/* ---------------------------------------------------------------- */
+
+uint64_t hashWorldBytes (const uint8_t *p, size_t n) {
+  uint64_t h;
+  uint64_t w;
+  size_t i;
+
+  h = 0xCBF29CE484222325ULL ^ n;
+  for (i = 0; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+    memcpy (&w, p + i, sizeof(uint64_t));
+    h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+  }
+  for ( ; i < n; i++)
+    h = (h ^ p[i]) * 0x9E3779B97F4A7C15ULL;
+  return h;
+}
+
+uint32_t checksumWorldChunk (const uint8_t *p, size_t n) {
+  uint64_t h;
+
+  h = hashWorldBytes (p, n);
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+uint32_t readWorldWord (const uint8_t *p) {
+  uint32_t w;
+
+  memcpy (&w, p, sizeof(uint32_t));
+  return w;
+}
+
+uint8_t *writeWorldLength (uint8_t *op, uint8_t *oend, size_t n) {
+  for ( ; n >= 255; n -= 255) {
+    if (op == oend)
+      return NULL;
+    *op++ = 255;
+  }
+  if (op == oend)
+    return NULL;
+  *op++ = (uint8_t)n;
+  return op;
+}
+
+/* compressWorldChunk (src, n, dst, capacity, table)
+ *
+ * compresses the n bytes at src into dst as a sequence of tokens, each
+ * with a count of literals that follow it and the length of a match at
+ * a 16-bit offset back; counts of 15 or more continue in the bytes
+ * that follow, as in LZ4.  The last token has only literals.  Returns
+ * the compressed size, or 0 if it would exceed capacity.  Matches are
+ * found with table, of 1 << GC_WORLD_HASH_BITS entries.
+ */
+size_t compressWorldChunk (const uint8_t *src, size_t n,
+                           uint8_t *dst, size_t capacity, uint32_t *table) {
+  const uint8_t *anchor, *end, *ip, *matchLimit;
+  uint8_t *op, *oend;
+  size_t misses;
+
+  memset (table, 0, sizeof(uint32_t) << GC_WORLD_HASH_BITS);
+  anchor = src;
+  end = src + n;
+  ip = src;
+  matchLimit = (n > 12) ? end - 12 : src;
+  op = dst;
+  oend = dst + capacity;
+  misses = 0;
+  while (ip < matchLimit) {
+    const uint8_t *m, *ref;
+    uint32_t h;
+    size_t lit, ml;
+    uint8_t *token;
+
+    h = (readWorldWord (ip) * 2654435761U) >> (32 - GC_WORLD_HASH_BITS);
+    ref = src + table[h];
+    table[h] = (uint32_t)(ip - src);
+    unless (ref < ip and ip - ref <= 0xFFFF
+            and readWorldWord (ref) == readWorldWord (ip)) {
+      /* Skip ahead faster in data that does not compress. */
+      ip += 1 + (misses++ >> 6);
+      continue;
+    }
+    misses = 0;
+    for (m = ip + 4; m < end - 5 and *m == ref[m - ip]; m++)
+      ;
+    lit = (size_t)(ip - anchor);
+    ml = (size_t)(m - ip) - 4;
+    if (op == oend)
+      return 0;
+    token = op++;
+    *token = (uint8_t)((min (lit, 15) << 4) | min (ml, 15));
+    if (lit >= 15 and NULL == (op = writeWorldLength (op, oend, lit - 15)))
+      return 0;
+    if (lit + 2 > (size_t)(oend - op))
+      return 0;
+    memcpy (op, anchor, lit);
+    op += lit;
+    *op++ = (uint8_t)((size_t)(ip - ref) & 0xFF);
+    *op++ = (uint8_t)((size_t)(ip - ref) >> 8);
+    if (ml >= 15 and NULL == (op = writeWorldLength (op, oend, ml - 15)))
+      return 0;
+    ip = m;
+    anchor = ip;
+  }
+  {
+    size_t lit;
+
+    lit = (size_t)(end - anchor);
+    if (op == oend)
+      return 0;
+    *op++ = (uint8_t)(min (lit, 15) << 4);
+    if (lit >= 15 and NULL == (op = writeWorldLength (op, oend, lit - 15)))
+      return 0;
+    if (lit > (size_t)(oend - op))
+      return 0;
+    memcpy (op, anchor, lit);
+    op += lit;
+  }
+  return (size_t)(op - dst);
+}
+
+/* decompressWorldChunk (src, n, dst, size)
+ *
+ * decompresses the n bytes at src, from compressWorldChunk, into the
+ * size bytes at dst.  Returns FALSE if they are not size bytes
+ * compressed, without writing outside dst.
+ */
+bool decompressWorldChunk (const uint8_t *src, size_t n,
+                           uint8_t *dst, size_t size) {
+  const uint8_t *ip, *iend;
+  uint8_t *op, *oend;
+
+  ip = src;
+  iend = src + n;
+  op = dst;
+  oend = dst + size;
+  while (ip < iend) {
+    size_t lit, ml, offset;
+    uint8_t token;
+
+    token = *ip++;
+    lit = token >> 4;
+    if (15 == lit) {
+      uint8_t b;
+
+      do {
+        if (ip == iend)
+          return FALSE;
+        b = *ip++;
+        lit += b;
+      } while (255 == b);
+    }
+    if (lit > (size_t)(iend - ip) or lit > (size_t)(oend - op))
+      return FALSE;
+    memcpy (op, ip, lit);
+    ip += lit;
+    op += lit;
+    if (ip == iend)
+      break;
+    if (iend - ip < 2)
+      return FALSE;
+    offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if (0 == offset or offset > (size_t)(op - dst))
+      return FALSE;
+    ml = token & 15;
+    if (15 == ml) {
+      uint8_t b;
+
+      do {
+        if (ip == iend)
+          return FALSE;
+        b = *ip++;
+        ml += b;
+      } while (255 == b);
+    }
+    ml += 4;
+    if (ml > (size_t)(oend - op))
+      return FALSE;
+    if (offset >= ml)
+      memcpy (op, op - offset, ml);
+    else
+      for (size_t i = 0; i < ml; i++)
+        op[i] = (op - offset)[i];
+    op += ml;
+  }
+  return op == oend;
+}
+
+/* ---------------------------------------------------------------- */
+/*                             Batches                              */
+/* ---------------------------------------------------------------- */
+
+size_t sizeofWorldChunk (struct GC_worldBatch *b, size_t i) {
+  size_t offset;
+
+  offset = (b->first + i) * b->chunkSize;
+  return min (b->chunkSize, b->imageSize - offset);
+}
+
+/* The jobs also run on the mutator's thread, with no worker, when
+ * there is a single GC thread.
+ */
+void compressWorldBatchJob (GC_state s) {
+  struct GC_parallelState *ps;
+  struct GC_worldBatch *b;
+  uint32_t *table;
+  size_t i;
+
+  ps = (NULL == s->worker) ? &s->parallelState : s->worker->parallel;
+  b = ps->worldBatch;
+  table = b->tables
+    + ((size_t)((NULL == s->worker) ? 0 : s->worker->id) << GC_WORLD_HASH_BITS);
+  while (claimRegion (ps, &i)) {
+    pointer p;
+    size_t n, size;
+
+    p = b->start + (b->first + i) * b->chunkSize;
+    n = sizeofWorldChunk (b, i);
+    size = compressWorldChunk (p, n, b->buffers + i * b->chunkSize, n - 1, table);
+    b->headers[i].checksum = checksumWorldChunk (p, n);
+    b->headers[i].size =
+      (0 == size) ? ((uint32_t)n | GC_WORLD_CHUNK_STORED) : (uint32_t)size;
+  }
+}
+
+void decompressWorldBatchJob (GC_state s) {
+  struct GC_parallelState *ps;
+  struct GC_worldBatch *b;
+  size_t i;
+
+  ps = (NULL == s->worker) ? &s->parallelState : s->worker->parallel;
+  b = ps->worldBatch;
+  while (claimRegion (ps, &i)) {
+    pointer p;
+    size_t n;
+    uint32_t size;
+
+    p = b->start + (b->first + i) * b->chunkSize;
+    n = sizeofWorldChunk (b, i);
+    size = b->headers[i].size;
+    /* A stored chunk was read into place. */
+    unless ((0 != (size & GC_WORLD_CHUNK_STORED)
+             or decompressWorldChunk (b->buffers + i * b->chunkSize, size, p, n))
+            and checksumWorldChunk (p, n) == b->headers[i].checksum)
+      __atomic_store_n (&b->corrupt, TRUE, __ATOMIC_RELAXED);
+  }
+}
+
+void runWorldBatchJob (GC_state s, struct GC_worldBatch *b, GC_parallelJob job) {
+  struct GC_parallelState *ps;
+
+  ps = &s->parallelState;
+  ps->worldBatch = b;
+  ps->nextRegion = 0;
+  ps->numRegions = b->numChunks;
+  if (useParallelGC (s))
+    runParallel (s, job);
+  else
+    job (s);
+  ps->worldBatch = NULL;
+}
+
+/* newWorldBatch (s, chunkSize, start, imageSize)
+ *
+ * returns a batch for the chunks of the heap image of imageSize bytes
+ * at start, or NULL if it cannot be allocated.
+ */
+struct GC_worldBatch *newWorldBatch (GC_state s, size_t chunkSize,
+                                     pointer start, size_t imageSize) {
+  struct GC_worldBatch *b;
+  size_t numThreads;
+
+  numThreads = max (s->parallelState.numThreads, 1u);
+  b = (struct GC_worldBatch *)(calloc (1, sizeof (struct GC_worldBatch)));
+  if (NULL == b)
+    return NULL;
+  b->chunkSize = chunkSize;
+  b->imageSize = imageSize;
+  b->maxChunks = GC_WORLD_BATCH_CHUNKS * numThreads;
+  b->start = start;
+  b->buffers = (uint8_t *)(malloc (b->maxChunks * chunkSize));
+  b->headers =
+    (struct GC_worldChunkHeader *)(calloc (b->maxChunks, sizeof (struct GC_worldChunkHeader)));
+  b->tables = (uint32_t *)(calloc (numThreads << GC_WORLD_HASH_BITS, sizeof(uint32_t)));
+  if (NULL == b->buffers or NULL == b->headers or NULL == b->tables) {
+    freeWorldBatch (b);
+    return NULL;
+  }
+  return b;
+}
+
+void freeWorldBatch (struct GC_worldBatch *b) {
+  if (NULL == b)
+    return;
+  free (b->buffers);
+  free (b->headers);
+  free (b->tables);
+  free (b);
+}
+
+/* ---------------------------------------------------------------- */
+/*                         Saving and loading                       */
+/* ---------------------------------------------------------------- */
+
+bool writeWorldBatch (FILE *f, struct GC_worldBatch *b) {
+  for (size_t i = 0; i < b->numChunks; i++) {
+    const uint8_t *data;
+    size_t size;
+
+    if (1 != fwrite (&b->headers[i], sizeof (struct GC_worldChunkHeader), 1, f))
+      return FALSE;
+    size = b->headers[i].size & ~GC_WORLD_CHUNK_STORED;
+    data = (0 != (b->headers[i].size & GC_WORLD_CHUNK_STORED))
+      ? b->start + (b->first + i) * b->chunkSize
+      : b->buffers + i * b->chunkSize;
+    if (size != fwrite (data, 1, size, f))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+void *worldWriter (void *arg) {
+  struct GC_worldWriter *w;
+
+  w = (struct GC_worldWriter *)arg;
+  pthread_mutex_lock (&w->lock);
+  while (TRUE) {
+    struct GC_worldBatch *b;
+    bool ok;
+
+    while (NULL == w->pending and not w->stop)
+      pthread_cond_wait (&w->cond, &w->lock);
+    b = w->pending;
+    if (NULL == b)
+      break;
+    pthread_mutex_unlock (&w->lock);
+    ok = w->failed or writeWorldBatch (w->f, b);
+    pthread_mutex_lock (&w->lock);
+    unless (ok)
+      w->failed = TRUE;
+    w->pending = NULL;
+    pthread_cond_broadcast (&w->cond);
+  }
+  pthread_mutex_unlock (&w->lock);
+  return NULL;
+}
+
+/* postWorldBatch (w, b)
+ *
+ * waits for the writer to finish the batch it is writing, and then
+ * hands it b to write, or stops it if b is NULL.
+ */
+void postWorldBatch (struct GC_worldWriter *w, struct GC_worldBatch *b) {
+  pthread_mutex_lock (&w->lock);
+  while (NULL != w->pending)
+    pthread_cond_wait (&w->cond, &w->lock);
+  if (NULL == b)
+    w->stop = TRUE;
+  else
+    w->pending = b;
+  pthread_cond_broadcast (&w->cond);
+  pthread_mutex_unlock (&w->lock);
+}
+
+/* saveWorldChunks (s, f)
+ *
+ * writes the chunks of the old generation to f.  The writer thread
+ * writes one of two batches while the other is compressed; without
+ * it, the batches are written in turn.  Returns -1 on failure.
+ */
+int saveWorldChunks (GC_state s, FILE *f) {
+  struct GC_worldBatch *batches[2];
+  uintmax_t bytesWritten;
+  size_t numChunks;
+  bool threaded;
+  struct GC_worldWriter w;
+
+  batches[0] = newWorldBatch (s, GC_WORLD_CHUNK_SIZE, s->heap.start, s->heap.oldGenSize);
+  batches[1] = newWorldBatch (s, GC_WORLD_CHUNK_SIZE, s->heap.start, s->heap.oldGenSize);
+  if (NULL == batches[0] or NULL == batches[1]) {
+    freeWorldBatch (batches[0]);
+    freeWorldBatch (batches[1]);
+    return -1;
+  }
+  numChunks = (s->heap.oldGenSize + GC_WORLD_CHUNK_SIZE - 1) / GC_WORLD_CHUNK_SIZE;
+  w.f = f;
+  w.failed = FALSE;
+  w.pending = NULL;
+  w.stop = FALSE;
+  threaded = FALSE;
+  if (0 == pthread_mutex_init (&w.lock, NULL)) {
+    if (0 == pthread_cond_init (&w.cond, NULL)) {
+      sigset_t all, old;
+
+      sigfillset (&all);
+      sigdelset (&all, SIGBUS);
+      sigdelset (&all, SIGFPE);
+      sigdelset (&all, SIGILL);
+      sigdelset (&all, SIGSEGV);
+      pthread_sigmask (SIG_BLOCK, &all, &old);
+      threaded = 0 == pthread_create (&w.thread, NULL, worldWriter, &w);
+      pthread_sigmask (SIG_SETMASK, &old, NULL);
+      unless (threaded)
+        pthread_cond_destroy (&w.cond);
+    }
+    unless (threaded)
+      pthread_mutex_destroy (&w.lock);
+  }
+  bytesWritten = 0;
+  for (size_t k = 0, first = 0; first < numChunks; k++) {
+    struct GC_worldBatch *b;
+
+    b = batches[k % 2];
+    b->first = first;
+    b->numChunks = min (b->maxChunks, numChunks - first);
+    runWorldBatchJob (s, b, compressWorldBatchJob);
+    for (size_t i = 0; i < b->numChunks; i++)
+      bytesWritten += sizeof (struct GC_worldChunkHeader)
+        + (b->headers[i].size & ~GC_WORLD_CHUNK_STORED);
+    if (threaded)
+      postWorldBatch (&w, b);
+    else unless (w.failed or writeWorldBatch (f, b))
+      w.failed = TRUE;
+    first += b->numChunks;
+  }
+  if (threaded) {
+    postWorldBatch (&w, NULL);
+    pthread_join (w.thread, NULL);
+    pthread_cond_destroy (&w.cond);
+    pthread_mutex_destroy (&w.lock);
+  }
+  freeWorldBatch (batches[0]);
+  freeWorldBatch (batches[1]);
+  if (s->controls.messages and not w.failed)
+    fprintf (stderr, "[GC: Saved heap image of %s bytes in %s bytes of chunks.]\n",
+             uintmaxToCommaString(s->heap.oldGenSize),
+             uintmaxToCommaString(bytesWritten));
+  return w.failed ? -1 : 0;
+}
+
+/* loadWorldChunks (s, f, chunkSize, imageSize)
+ *
+ * reads the chunks of chunkSize bytes of a heap image of imageSize
+ * bytes from f into the heap, a batch at a time, and decompresses and
+ * checks each batch.
+ */
+void loadWorldChunks (GC_state s, FILE *f, size_t chunkSize, size_t imageSize) {
+  struct GC_worldBatch *b;
+  size_t numChunks;
+
+  b = newWorldBatch (s, chunkSize, s->heap.start, imageSize);
+  if (NULL == b)
+    die ("Out of memory.  Unable to allocate %s bytes to load world.",
+         uintmaxToCommaString (chunkSize));
+  numChunks = (imageSize + chunkSize - 1) / chunkSize;
+  for (size_t first = 0; first < numChunks; first += b->numChunks) {
+    b->first = first;
+    b->numChunks = min (b->maxChunks, numChunks - first);
+    for (size_t i = 0; i < b->numChunks; i++) {
+      size_t n, size;
+
+      fread_safe (&b->headers[i], sizeof (struct GC_worldChunkHeader), 1, f);
+      n = sizeofWorldChunk (b, i);
+      size = b->headers[i].size & ~GC_WORLD_CHUNK_STORED;
+      if (0 != (b->headers[i].size & GC_WORLD_CHUNK_STORED)) {
+        unless (size == n)
+          die ("Invalid world: corrupt heap image.");
+        fread_safe (b->start + (first + i) * chunkSize, 1, n, f);
+      } else {
+        unless (size < n)
+          die ("Invalid world: corrupt heap image.");
+        fread_safe (b->buffers + i * chunkSize, 1, size, f);
+      }
+    }
+    runWorldBatchJob (s, b, decompressWorldBatchJob);
+    if (b->corrupt)
+      die ("Invalid world: corrupt heap image.");
+  }
+  freeWorldBatch (b);
+}
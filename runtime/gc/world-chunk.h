@@ -0,0 +1,79 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With compress-world, the heap image of a world is saved as chunks
+ * of GC_WORLD_CHUNK_SIZE bytes, each compressed with an LZ77 scheme
+ * in the style of LZ4 and preceded by a GC_worldChunkHeader.  A chunk
+ * that does not compress is stored as it is.  The checksum is of the
+ * uncompressed chunk, and is checked as the world is loaded.
+ *
+ * Chunks are compressed, and decompressed, a batch at a time, by the
+ * GC threads if there are several.  As a world is saved, a writer
+ * thread writes one batch while the next is compressed.
+ */
+#define GC_WORLD_CHUNK_SIZE 0x100000
+#define GC_WORLD_CHUNK_STORED 0x80000000
+#define GC_WORLD_BATCH_CHUNKS 2 /* Per GC thread. */
+#define GC_WORLD_HASH_BITS 14
+
+struct GC_worldChunkHeader {
+  uint32_t checksum;
+  uint32_t size; /* Of the data that follows, | GC_WORLD_CHUNK_STORED. */
+};
+
+struct GC_worldBatch {
+  uint8_t *buffers; /* Compressed data, chunkSize bytes for each chunk. */
+  size_t chunkSize;
+  bool corrupt; /* A chunk failed to decompress or to check. */
+  size_t first; /* Index of the first chunk. */
+  struct GC_worldChunkHeader *headers;
+  size_t imageSize;
+  size_t maxChunks;
+  size_t numChunks;
+  pointer start; /* Of the heap image. */
+  uint32_t *tables; /* Hash table of each GC thread. */
+};
+
+struct GC_worldWriter {
+  pthread_cond_t cond;
+  bool failed;
+  FILE *f;
+  pthread_mutex_t lock;
+  struct GC_worldBatch *pending; /* Being written, or NULL. */
+  bool stop;
+  pthread_t thread;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static uint64_t hashWorldBytes (const uint8_t *p, size_t n);
+static inline uint32_t checksumWorldChunk (const uint8_t *p, size_t n);
+static inline uint32_t readWorldWord (const uint8_t *p);
+static inline uint8_t *writeWorldLength (uint8_t *op, uint8_t *oend, size_t n);
+static size_t compressWorldChunk (const uint8_t *src, size_t n,
+                                  uint8_t *dst, size_t capacity, uint32_t *table);
+static bool decompressWorldChunk (const uint8_t *src, size_t n,
+                                  uint8_t *dst, size_t size);
+
+static inline size_t sizeofWorldChunk (struct GC_worldBatch *b, size_t i);
+static void compressWorldBatchJob (GC_state s);
+static void decompressWorldBatchJob (GC_state s);
+static void runWorldBatchJob (GC_state s, struct GC_worldBatch *b, GC_parallelJob job);
+static struct GC_worldBatch *newWorldBatch (GC_state s, size_t chunkSize,
+                                            pointer start, size_t imageSize);
+static void freeWorldBatch (struct GC_worldBatch *b);
+
+static bool writeWorldBatch (FILE *f, struct GC_worldBatch *b);
+static void *worldWriter (void *arg);
+static void postWorldBatch (struct GC_worldWriter *w, struct GC_worldBatch *b);
+static int saveWorldChunks (GC_state s, FILE *f);
+static void loadWorldChunks (GC_state s, FILE *f, size_t chunkSize, size_t imageSize);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -0,0 +1,255 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* ---------------------------------------------------------------- */
+/*                              Pages                               */
+/* ---------------------------------------------------------------- */
+
+uint64_t newWorldId (GC_state s) {
+  static uint64_t count = 0;
+  uint64_t id;
+  uint64_t seed[4];
+
+  seed[0] = (uint64_t)time (NULL);
+  seed[1] = (uint64_t)getpid ();
+  seed[2] = ++count;
+  seed[3] = (uint64_t)(uintptr_t)s->heap.start;
+  id = hashWorldBytes ((const uint8_t*)seed, sizeof(seed));
+  return (0 == id) ? 1 : id;
+}
+
+size_t sizeofWorldPages (size_t size) {
+  return (size + GC_WORLD_PAGE_SIZE - 1) / GC_WORLD_PAGE_SIZE;
+}
+
+/* The size of page i of a heap image of size bytes. */
+size_t sizeofWorldPage (size_t size, size_t i) {
+  return min ((size_t)GC_WORLD_PAGE_SIZE, size - i * GC_WORLD_PAGE_SIZE);
+}
+
+/* hashWorldPages (s)
+ *
+ * returns the hashes of the pages of the old generation.  The size of
+ * a page is in its hash, so that the last page of a world is not taken
+ * to be the same as a longer page of a world saved after it.
+ */
+uint64_t *hashWorldPages (GC_state s) {
+  uint64_t *hashes;
+  size_t numPages;
+
+  numPages = sizeofWorldPages (s->heap.oldGenSize);
+  hashes = (uint64_t*)(malloc_safe (max (numPages, (size_t)1) * sizeof(uint64_t)));
+  for (size_t i = 0; i < numPages; i++) {
+    size_t n;
+
+    n = sizeofWorldPage (s->heap.oldGenSize, i);
+    hashes[i] = hashWorldBytes (s->heap.start + i * GC_WORLD_PAGE_SIZE, n) ^ n;
+  }
+  return hashes;
+}
+
+/* ---------------------------------------------------------------- */
+/*                          The last world                          */
+/* ---------------------------------------------------------------- */
+
+void forgetLastWorld (GC_state s) {
+  free (s->lastWorld.chain);
+  free (s->lastWorld.fileName);
+  free (s->lastWorld.pageHashes);
+  s->lastWorld.chain = NULL;
+  s->lastWorld.chainLength = 0;
+  s->lastWorld.fileName = NULL;
+  s->lastWorld.id = 0;
+  s->lastWorld.numPages = 0;
+  s->lastWorld.pageHashes = NULL;
+  s->lastWorld.start = NULL;
+}
+
+void addWorldToChain (GC_state s, FILE *f) {
+  struct stat st;
+
+  if (0 != fstat (fileno (f), &st))
+    diee ("couldn't stat world");
+  s->lastWorld.chain =
+    (struct GC_worldFile*)(realloc (s->lastWorld.chain,
+                                    (s->lastWorld.chainLength + 1)
+                                    * sizeof(struct GC_worldFile)));
+  if (NULL == s->lastWorld.chain)
+    die ("Out of memory.");
+  s->lastWorld.chain[s->lastWorld.chainLength].dev = st.st_dev;
+  s->lastWorld.chain[s->lastWorld.chainLength].ino = st.st_ino;
+  s->lastWorld.chainLength++;
+}
+
+/* rememberLastWorld (s, fileName, f, start, id, hashes, delta)
+ *
+ * makes the world with id in f, whose heap image was at start and has
+ * the page hashes, the last world.  If it is a delta, its ancestors
+ * are those of the last world.  Takes hashes.
+ */
+void rememberLastWorld (GC_state s, const char *fileName, FILE *f,
+                        pointer start, uint64_t id,
+                        uint64_t *hashes, bool delta) {
+  struct GC_worldFile *chain;
+  size_t chainLength;
+
+  chain = s->lastWorld.chain;
+  chainLength = s->lastWorld.chainLength;
+  s->lastWorld.chain = NULL;
+  forgetLastWorld (s);
+  if (delta) {
+    s->lastWorld.chain = chain;
+    s->lastWorld.chainLength = chainLength;
+  } else
+    free (chain);
+  addWorldToChain (s, f);
+  s->lastWorld.fileName = strdup (fileName);
+  if (NULL == s->lastWorld.fileName)
+    die ("Out of memory.");
+  s->lastWorld.id = id;
+  s->lastWorld.numPages = sizeofWorldPages (s->heap.oldGenSize);
+  s->lastWorld.pageHashes = hashes;
+  s->lastWorld.start = start;
+}
+
+/* isWorldInChain (s, fileName)
+ *
+ * returns TRUE if fileName is the file of the last world or of one of
+ * its ancestors, which a delta of the last world would need.
+ */
+bool isWorldInChain (GC_state s, const char *fileName) {
+  struct stat st;
+
+  unless (0 == stat (fileName, &st))
+    return FALSE;
+  for (size_t i = 0; i < s->lastWorld.chainLength; i++)
+    if (st.st_dev == s->lastWorld.chain[i].dev
+        and st.st_ino == s->lastWorld.chain[i].ino)
+      return TRUE;
+  return FALSE;
+}
+
+/* ---------------------------------------------------------------- */
+/*                              Deltas                              */
+/* ---------------------------------------------------------------- */
+
+/* writeWorldDelta (s, f, hashes)
+ *
+ * writes the bitmap of the pages of the old generation, with hashes,
+ * that differ from the pages of the last world, and then those pages.
+ */
+int writeWorldDelta (GC_state s, FILE *f, uint64_t *hashes) {
+  uint64_t *bitmap;
+  size_t bitmapLength;
+  size_t numPages;
+  int res;
+
+  numPages = sizeofWorldPages (s->heap.oldGenSize);
+  bitmapLength = (numPages + 63) / 64;
+  bitmap = (uint64_t*)(calloc (max (bitmapLength, (size_t)1), sizeof(uint64_t)));
+  if (NULL == bitmap)
+    return -1;
+  for (size_t i = 0; i < numPages; i++)
+    unless (i < s->lastWorld.numPages
+            and hashes[i] == s->lastWorld.pageHashes[i])
+      bitmap[i / 64] |= (uint64_t)1 << (i % 64);
+  res = -1;
+  if (fwrite (bitmap, sizeof(uint64_t), bitmapLength, f) != bitmapLength)
+    goto done;
+  for (size_t i = 0; i < numPages; i++) {
+    size_t n;
+
+    unless (bitmap[i / 64] & ((uint64_t)1 << (i % 64)))
+      continue;
+    n = sizeofWorldPage (s->heap.oldGenSize, i);
+    if (fwrite (s->heap.start + i * GC_WORLD_PAGE_SIZE, 1, n, f) != n)
+      goto done;
+  }
+  res = 0;
+done:
+  free (bitmap);
+  return res;
+}
+
+/* readWorldDelta (s, f, size)
+ *
+ * reads the pages of the heap image, of size bytes, of a delta over
+ * those of its parent in the heap.
+ */
+void readWorldDelta (GC_state s, FILE *f, size_t size) {
+  uint64_t *bitmap;
+  size_t bitmapLength;
+  size_t numPages;
+
+  numPages = sizeofWorldPages (size);
+  bitmapLength = (numPages + 63) / 64;
+  bitmap = (uint64_t*)(malloc_safe (max (bitmapLength, (size_t)1) * sizeof(uint64_t)));
+  fread_safe (bitmap, sizeof(uint64_t), bitmapLength, f);
+  for (size_t i = 0; i < numPages; i++)
+    if (bitmap[i / 64] & ((uint64_t)1 << (i % 64)))
+      fread_safe (s->heap.start + i * GC_WORLD_PAGE_SIZE,
+                  1, sizeofWorldPage (size, i), f);
+  free (bitmap);
+}
+
+/* openWorldParent (s, h, parent)
+ *
+ * opens the parent of the delta of header h, reads its header into
+ * parent, and checks that it is the world that the delta was saved
+ * from.
+ */
+FILE *openWorldParent (GC_state s, struct GC_worldHeader *h,
+                       struct GC_worldHeader *parent) {
+  FILE *f;
+
+  if (DEBUG_WORLD)
+    fprintf (stderr, "openWorldParent (%s)\n", h->parentName);
+  f = fopen_safe (h->parentName, "rb");
+  readWorldHeader (s, f, parent);
+  unless (parent->id == h->parentId and parent->start == h->start)
+    die ("Invalid world: %s is not the world that the delta was saved from.",
+         h->parentName);
+  return f;
+}
+
+/* sizeofWorldChain (s, h)
+ *
+ * returns the size of the largest heap image of the world of header h
+ * and its ancestors, which the heap must hold as it is loaded.
+ */
+size_t sizeofWorldChain (GC_state s, struct GC_worldHeader *h) {
+  struct GC_worldHeader parent;
+  FILE *f;
+  size_t res;
+
+  if (0 == h->parentId)
+    return h->oldGenSize;
+  f = openWorldParent (s, h, &parent);
+  fclose_safe (f);
+  res = max (h->oldGenSize, sizeofWorldChain (s, &parent));
+  free (parent.parentName);
+  return res;
+}
+
+/* loadWorldParent (s, h)
+ *
+ * loads the heap image of the parent of the delta of header h, and of
+ * its ancestors, into the heap, and adds their files to the chain of
+ * the last world.
+ */
+void loadWorldParent (GC_state s, struct GC_worldHeader *h) {
+  struct GC_worldHeader parent;
+  FILE *f;
+
+  f = openWorldParent (s, h, &parent);
+  if (0 != parent.parentId)
+    loadWorldParent (s, &parent);
+  skipWorldPadding (f, &parent);
+  readWorldImage (s, f, &parent);
+  addWorldToChain (s, f);
+  fclose_safe (f);
+  free (parent.parentName);
+}
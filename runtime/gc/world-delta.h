@@ -0,0 +1,60 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* With delta-world, a world that is saved after a world was saved or
+ * loaded is saved as a delta of that world, its parent, whose id and
+ * file name are in its header.  The heap image of a delta is a bitmap,
+ * with a bit for each page of GC_WORLD_PAGE_SIZE bytes of the old
+ * generation, followed by the pages whose hashes differ from the
+ * hashes of the pages of its parent.  A delta is loaded by loading its
+ * parent, and then reading its pages over its parent's.
+ */
+#define GC_WORLD_PAGE_SIZE 0x1000
+
+struct GC_worldFile {
+  dev_t dev;
+  ino_t ino;
+};
+
+/* The world that was last saved or loaded, which the next world saved
+ * may be a delta of.
+ */
+struct GC_lastWorld {
+  struct GC_worldFile *chain; /* Its file and those of its ancestors. */
+  size_t chainLength;
+  char *fileName;
+  uint64_t id; /* 0 if none. */
+  size_t numPages;
+  uint64_t *pageHashes;
+  pointer start; /* Of its heap image. */
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
+#if (defined (MLTON_GC_INTERNAL_FUNCS))
+
+static uint64_t newWorldId (GC_state s);
+static inline size_t sizeofWorldPages (size_t size);
+static inline size_t sizeofWorldPage (size_t size, size_t i);
+static uint64_t *hashWorldPages (GC_state s);
+
+static void forgetLastWorld (GC_state s);
+static void addWorldToChain (GC_state s, FILE *f);
+static void rememberLastWorld (GC_state s, const char *fileName, FILE *f,
+                               pointer start, uint64_t id,
+                               uint64_t *hashes, bool delta);
+static bool isWorldInChain (GC_state s, const char *fileName);
+
+static int writeWorldDelta (GC_state s, FILE *f, uint64_t *hashes);
+static void readWorldDelta (GC_state s, FILE *f, size_t size);
+static FILE *openWorldParent (GC_state s, struct GC_worldHeader *h,
+                              struct GC_worldHeader *parent);
+static size_t sizeofWorldChain (GC_state s, struct GC_worldHeader *h);
+static void loadWorldParent (GC_state s, struct GC_worldHeader *h);
+
+#endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
@@ -6,34 +6,206 @@
  * See the file MLton-LICENSE for details.
  */
 
-void loadWorldFromFILE (GC_state s, FILE *f) {
-  uint32_t magic;
-  pointer start;
+/* sizeofWorldHeader (textSize, parentName)
+ *
+ * returns the size of the header of a world file whose text, with its
+ * '\000', is textSize bytes, and that is a delta of parentName, if it
+ * is not NULL.
+ */
+size_t sizeofWorldHeader (size_t textSize, const char *parentName) {
+  return textSize
+    + sizeof(uint32_t) /* magic */
+    + sizeof(uintptr_t) /* heap.start */
+    + sizeof(size_t) /* heap.oldGenSize */
+    + sizeof(uint32_t) /* atomicState */
+    + 3 * sizeof(objptr) /* callFromCHandlerThread, currentThread,
+                          * signalHandlerThread */
+    + sizeof(size_t) /* size of the relocation map */
+    + sizeof(size_t) /* size of the chunks of the heap image, or 0 */
+    + 2 * sizeof(uint64_t) /* id, parentId */
+    + sizeof(size_t) /* size of parentName, with its '\000', or 0 */
+    + ((NULL == parentName) ? 0 : strlen (parentName) + 1);
+}
+
+void readWorldHeader (GC_state s, FILE *f, struct GC_worldHeader *h) {
+  size_t parentNameSize;
+
+  h->textSize = 1;
+  until (readChar (f) == '\000')
+    h->textSize++;
+  unless (s->magic == readUint32 (f))
+    die ("Invalid world: wrong magic number.");
+  h->start = readPointer (f);
+  h->oldGenSize = readSize (f);
+  h->atomicState = readUint32 (f);
+  h->callFromCHandlerThread = readObjptr (f);
+  h->currentThread = readObjptr (f);
+  h->signalHandlerThread = readObjptr (f);
+  h->mapSize = readSize (f);
+  unless (0 == h->mapSize or sizeofRelocationMap (h->oldGenSize) == h->mapSize)
+    die ("Invalid world: wrong relocation map size.");
+  h->chunkSize = readSize (f);
+  unless (h->chunkSize < GC_WORLD_CHUNK_STORED)
+    die ("Invalid world: wrong chunk size.");
+  fread_safe (&h->id, sizeof(uint64_t), 1, f);
+  fread_safe (&h->parentId, sizeof(uint64_t), 1, f);
+  parentNameSize = readSize (f);
+  unless ((0 == h->parentId) == (0 == parentNameSize)
+          and parentNameSize < GC_WORLD_HEAP_ALIGN)
+    die ("Invalid world: wrong delta.");
+  h->parentName = NULL;
+  if (parentNameSize > 0) {
+    h->parentName = (char *)(malloc_safe (parentNameSize));
+    fread_safe (h->parentName, 1, parentNameSize, f);
+    unless ('\000' == h->parentName[parentNameSize - 1])
+      die ("Invalid world: wrong delta.");
+  }
+}
+
+/* skipWorldBytes (f, n)
+ *
+ * skips n bytes of f, which need not be seekable.
+ */
+void skipWorldBytes (FILE *f, uintmax_t n) {
+  if (n <= (uintmax_t)LONG_MAX and 0 == fseek (f, (long)n, SEEK_CUR))
+    return;
+  for ( ; n > 0; n--)
+    readChar (f);
+}
+
+/* Skip the padding before the heap image of the world of header h. */
+void skipWorldPadding (FILE *f, struct GC_worldHeader *h) {
+  size_t headerSize;
+
+  headerSize = sizeofWorldHeader (h->textSize, h->parentName);
+  skipWorldBytes (f, align (headerSize, GC_WORLD_HEAP_ALIGN) - headerSize);
+}
+
+/* readWorldImage (s, f, h)
+ *
+ * reads the heap image of the world of header h into the heap, which
+ * holds the image of the world that it is a delta of, if it is one.
+ */
+void readWorldImage (GC_state s, FILE *f, struct GC_worldHeader *h) {
+  if (0 != h->parentId)
+    readWorldDelta (s, f, h->oldGenSize);
+  else if (0 != h->chunkSize)
+    loadWorldChunks (s, f, h->chunkSize, h->oldGenSize);
+  else
+    fread_safe (s->heap.start, 1, h->oldGenSize, f);
+}
+
+/* mapWorldHeap (s, f, start, offset, relocatable)
+ *
+ * maps the heap image of the world in f, which starts at offset, over
+ * the old generation, if the heap is at start, where the world's was,
+ * or if the world has a relocation map, so that only the pages with
+ * objptrs are touched by translateHeapByMap.  The image is then read
+ * as its pages are touched, and pages that are only read are shared
+ * with other processes that load the world.  Returns FALSE if it does
+ * not, and the image must be read.
+ */
+bool mapWorldHeap (GC_state s, FILE *f, pointer start, uintmax_t offset,
+                   bool relocatable) {
+  struct stat st;
+  size_t length;
+
+  unless (s->controls.mapWorld
+          and (start == s->heap.start or relocatable)
+          and not s->heap.explicitHugePages
+          and s->heap.oldGenSize > 0
+          and 0 == offset % s->sysvals.pageSize
+          and offset + s->heap.oldGenSize <= (uintmax_t)LONG_MAX)
+    return FALSE;
+  /* A truncated world would fault when its missing pages are touched,
+   * rather than fail to load.
+   */
+  unless (0 == fstat (fileno (f), &st)
+          and S_ISREG (st.st_mode)
+          and (uintmax_t)st.st_size >= offset + s->heap.oldGenSize)
+    return FALSE;
+  length = align (s->heap.oldGenSize, s->sysvals.pageSize);
+  if ((void*)-1 == GC_mapFile (s->heap.start, length, fileno (f), offset)) {
+    if (s->controls.messages)
+      fprintf (stderr, "[GC: Unable to map world heap image; reading it.]\n");
+    return FALSE;
+  }
+  s->mappedWorld.dev = st.st_dev;
+  s->mappedWorld.ino = st.st_ino;
+  s->mappedWorld.mapped = TRUE;
+  if (DEBUG or s->controls.messages)
+    fprintf (stderr, "[GC: Mapped world heap image of %s bytes at "FMTPTR".]\n",
+             uintmaxToCommaString(s->heap.oldGenSize),
+             (uintptr_t)(s->heap.start));
+  return TRUE;
+}
+
+void loadWorldFromFILE (GC_state s, FILE *f, const char *fileName) {
+  struct GC_worldHeader h;
+  uint64_t *map;
+  size_t minSize;
+  uintmax_t offset;
 
   if (DEBUG_WORLD)
     fprintf (stderr, "loadWorldFromFILE\n");
-  until (readChar (f) == '\000') ;
-  magic = readUint32 (f);
-  unless (s->magic == magic)
-    die ("Invalid world: wrong magic number.");
-  start = readPointer (f);
-  s->heap.oldGenSize = readSize (f);
-  s->atomicState = readUint32 (f);
-  s->callFromCHandlerThread = readObjptr (f);
-  s->currentThread = readObjptr (f);
-  s->signalHandlerThread = readObjptr (f);
-  createHeap (s, &s->heap,
-              sizeofHeapDesired (s, s->heap.oldGenSize, 0),
-              s->heap.oldGenSize);
+  readWorldHeader (s, f, &h);
+  s->heap.oldGenSize = h.oldGenSize;
+  s->atomicState = h.atomicState;
+  s->callFromCHandlerThread = h.callFromCHandlerThread;
+  s->currentThread = h.currentThread;
+  s->signalHandlerThread = h.signalHandlerThread;
+  /* The worlds that a delta replays may have larger heap images. */
+  minSize = sizeofWorldChain (s, &h);
+  /* A heap where the world's was needs no translation, and lets the
+   * heap image be mapped.
+   */
+  unless (createHeapAt (s, &s->heap, h.start,
+                        sizeofHeapDesired (s, s->heap.oldGenSize, 0),
+                        minSize))
+    createHeap (s, &s->heap,
+                sizeofHeapDesired (s, s->heap.oldGenSize, 0),
+                minSize);
   setCardMapAndCrossMap (s);
-  fread_safe (s->heap.start, 1, s->heap.oldGenSize, f);
+  offset = align (sizeofWorldHeader (h.textSize, h.parentName), GC_WORLD_HEAP_ALIGN);
+  forgetLastWorld (s);
+  if (0 == h.chunkSize and 0 == h.parentId
+      and mapWorldHeap (s, f, h.start, offset, 0 != h.mapSize)) {
+    if (0 != fseek (f, (long)(offset + s->heap.oldGenSize), SEEK_SET))
+      diee ("couldn't seek past world heap image");
+  } else {
+    if (0 != h.parentId)
+      loadWorldParent (s, &h);
+    skipWorldPadding (f, &h);
+    readWorldImage (s, f, &h);
+  }
+  /* The pages are hashed before they are translated, as they are in
+   * the file.
+   */
+  if (s->controls.deltaWorld)
+    rememberLastWorld (s, fileName, f, h.start, h.id,
+                       hashWorldPages (s), 0 != h.parentId);
+  else
+    forgetLastWorld (s);
+  free (h.parentName);
+  map = NULL;
+  if (h.start == s->heap.start or 0 == h.mapSize)
+    skipWorldBytes (f, h.mapSize);
+  else {
+    map = (uint64_t*)(malloc_safe (h.mapSize));
+    fread_safe (map, 1, h.mapSize, f);
+  }
   if ((*(s->loadGlobals)) (f) != 0) diee("couldn't load globals");
   // unless (EOF == fgetc (file))
   //  die ("Invalid world: junk at end of file.");
   /* translateHeap must occur after loading the heap and globals,
    * since it changes pointers in all of them.
    */
-  translateHeap (s, start, s->heap.start, s->heap.oldGenSize);
+  if (NULL == map)
+    translateHeap (s, h.start, s->heap.start, s->heap.oldGenSize);
+  else {
+    translateHeapByMap (s, h.start, s->heap.start, s->heap.oldGenSize, map);
+    free (map);
+  }
   setGCStateCurrentHeap (s, 0, 0);
   setGCStateCurrentThreadAndStack (s);
 }
@@ -44,62 +216,144 @@ void loadWorldFromFileName (GC_state s, const char *fileName) {
   if (DEBUG_WORLD)
     fprintf (stderr, "loadWorldFromFileName (%s)\n", fileName);
   f = fopen_safe (fileName, "rb");
-  loadWorldFromFILE (s, f);
+  loadWorldFromFILE (s, f, fileName);
   fclose_safe (f);
 }
 
 /* Don't use 'safe' functions, because we don't want the ML program to die.
  * Instead, check return values, and propogate them up to SML for an exception.
  */
-int saveWorldToFILE (GC_state s, FILE *f) {
+int saveWorldToFILE (GC_state s, FILE *f, const char *fileName, bool delta) {
   char buf[128];
   size_t len;
+  size_t chunkSize;
+  uint64_t *hashes;
+  uint64_t id;
+  uint64_t *map;
+  size_t mapSize;
+  uint64_t parentId;
+  const char *parentName;
+  size_t parentNameSize;
+  int res;
+  pointer start;
 
   if (DEBUG_WORLD)
     fprintf (stderr, "saveWorldToFILE\n");
-  /* Compact the heap. */
-  performGC (s, 0, 0, TRUE, TRUE);
+  /* Compact the heap, with room for the large objects.  The pages of
+   * a delta only match its parent's if the objects that were not moved
+   * since are not moved by the compaction, as they are not by a
+   * mark-compact.
+   */
+  s->markCompactDuringGC = delta;
+  performGC (s, s->largeObjects.bytes, 0, TRUE, TRUE);
+  absorbLargeObjects (s);
+  /* The relocation map lets a load at another address translate the
+   * heap without walking its objects; see translateHeapByMap.
+   */
+  map = buildRelocationMap (s, s->heap.start, s->heap.oldGenSize);
+  mapSize = (NULL == map) ? 0 : sizeofRelocationMap (s->heap.oldGenSize);
+  /* A delta's pages replace those of its parent's image, so it is
+   * saved as if the heap were where its parent's was.
+   */
+  delta = delta and (s->heap.start == s->lastWorld.start or NULL != map);
+  start = delta ? s->lastWorld.start : s->heap.start;
+  rebaseHeap (s, s->heap.start, start, map);
+  hashes = s->controls.deltaWorld ? hashWorldPages (s) : NULL;
+  chunkSize = (s->controls.compressWorld and not delta) ? GC_WORLD_CHUNK_SIZE : 0;
+  id = newWorldId (s);
+  parentId = delta ? s->lastWorld.id : 0;
+  parentName = delta ? s->lastWorld.fileName : NULL;
+  parentNameSize = delta ? strlen (parentName) + 1 : 0;
+  res = -1;
   snprintf (buf, cardof(buf),
             "Heap file created by MLton.\nheap.start = "FMTPTR"\nbytesLive = %"PRIuMAX"\n",
-            (uintptr_t)s->heap.start,
+            (uintptr_t)start,
             (uintmax_t)s->lastMajorStatistics.bytesLive);
   len = strlen(buf) + 1; /* +1 to get the '\000' */
 
-  if (fwrite (buf, 1, len, f) != len) return -1;
-  if (fwrite (&s->magic, sizeof(uint32_t), 1, f) != 1) return -1;
-  if (fwrite (&s->heap.start, sizeof(uintptr_t), 1, f) != 1) return -1;
-  if (fwrite (&s->heap.oldGenSize, sizeof(size_t), 1, f) != 1) return -1;
+  if (fwrite (buf, 1, len, f) != len) goto done;
+  if (fwrite (&s->magic, sizeof(uint32_t), 1, f) != 1) goto done;
+  if (fwrite (&start, sizeof(uintptr_t), 1, f) != 1) goto done;
+  if (fwrite (&s->heap.oldGenSize, sizeof(size_t), 1, f) != 1) goto done;
 
   /* atomicState must be saved in the heap, because the saveWorld may
    * be run in the context of a critical section, which will expect to
    * be in the same context when it is restored.
    */
-  if (fwrite (&s->atomicState, sizeof(uint32_t), 1, f) != 1) return -1;
-  if (fwrite (&s->callFromCHandlerThread, sizeof(objptr), 1, f) != 1) return -1;
-  if (fwrite (&s->currentThread, sizeof(objptr), 1, f) != 1) return -1;
-  if (fwrite (&s->signalHandlerThread, sizeof(objptr), 1, f) != 1) return -1;
+  if (fwrite (&s->atomicState, sizeof(uint32_t), 1, f) != 1) goto done;
+  if (fwrite (&s->callFromCHandlerThread, sizeof(objptr), 1, f) != 1) goto done;
+  if (fwrite (&s->currentThread, sizeof(objptr), 1, f) != 1) goto done;
+  if (fwrite (&s->signalHandlerThread, sizeof(objptr), 1, f) != 1) goto done;
+  if (fwrite (&mapSize, sizeof(size_t), 1, f) != 1) goto done;
+  if (fwrite (&chunkSize, sizeof(size_t), 1, f) != 1) goto done;
+  if (fwrite (&id, sizeof(uint64_t), 1, f) != 1) goto done;
+  if (fwrite (&parentId, sizeof(uint64_t), 1, f) != 1) goto done;
+  if (fwrite (&parentNameSize, sizeof(size_t), 1, f) != 1) goto done;
+  if (parentNameSize > 0
+      and fwrite (parentName, 1, parentNameSize, f) != parentNameSize)
+    goto done;
+  /* Pad the header, so that the heap image is aligned. */
+  for (size_t i = sizeofWorldHeader (len, parentName);
+       i < align (sizeofWorldHeader (len, parentName), GC_WORLD_HEAP_ALIGN);
+       i++)
+    if (EOF == fputc ('\000', f)) goto done;
 
-  if (fwrite (s->heap.start, 1, s->heap.oldGenSize, f) != s->heap.oldGenSize)
-    return -1;
+  if (delta) {
+    if (writeWorldDelta (s, f, hashes) != 0)
+      goto done;
+  } else if (0 == chunkSize) {
+    if (fwrite (s->heap.start, 1, s->heap.oldGenSize, f) != s->heap.oldGenSize)
+      goto done;
+  } else if (saveWorldChunks (s, f) != 0)
+    goto done;
+  if (mapSize > 0 and fwrite (map, 1, mapSize, f) != mapSize)
+    goto done;
   if ((*(s->saveGlobals)) (f) != 0)
-    return -1;
-  return 0;
+    goto done;
+  res = 0;
+done:
+  rebaseHeap (s, start, s->heap.start, map);
+  free (map);
+  if (0 == res and NULL != hashes)
+    rememberLastWorld (s, fileName, f, start, id, hashes, delta);
+  else {
+    free (hashes);
+    forgetLastWorld (s);
+  }
+  return res;
 }
 
 void GC_saveWorld (GC_state s, NullString8_t fileName) {
+  bool delta;
   FILE *f;
 
   enter (s);
+  /* A delta must not be written over a world that it needs. */
+  delta = s->controls.deltaWorld
+    and 0 != s->lastWorld.id
+    and not isWorldInChain (s, (const char*)fileName);
+  /* Writing over the file of the loaded world would change the pages
+   * of its heap image that are still mapped, so write a new file.
+   */
+  if (s->mappedWorld.mapped) {
+    struct stat st;
+
+    if (0 == stat ((const char*)fileName, &st)
+        and st.st_dev == s->mappedWorld.dev
+        and st.st_ino == s->mappedWorld.ino)
+      unlink ((const char*)fileName);
+  }
   f = fopen ((const char*)fileName, "wb");
   if (f == 0) {
     s->saveWorldStatus = false;
     goto done;
   }
-  if (saveWorldToFILE (s, f) != 0) {
+  if (saveWorldToFILE (s, f, (const char*)fileName, delta) != 0) {
     s->saveWorldStatus = false;
     goto done;
   }
   if (fclose (f) != 0) {
+    forgetLastWorld (s);
     s->saveWorldStatus = false;
     goto done;
   }
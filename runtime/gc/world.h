@@ -6,11 +6,53 @@
  * See the file MLton-LICENSE for details.
  */
 
+#if (defined (MLTON_GC_INTERNAL_TYPES))
+
+/* A world file is its header, padding up to a multiple of
+ * GC_WORLD_HEAP_ALIGN, the heap image, its relocation map, if any, and
+ * the globals.  Aligning the heap image lets mapWorldHeap map it from
+ * the file.  With compress-world, the heap image is saved as chunks;
+ * see world-chunk.h.
+ */
+#define GC_WORLD_HEAP_ALIGN 0x10000
+
+/* The fields of the header of a world file, which follow its text. */
+struct GC_worldHeader {
+  uint32_t atomicState;
+  objptr callFromCHandlerThread;
+  size_t chunkSize; /* Of the heap image, or 0; see world-chunk.h. */
+  objptr currentThread;
+  uint64_t id;
+  size_t mapSize; /* Of the relocation map, or 0. */
+  size_t oldGenSize;
+  uint64_t parentId; /* If a delta, else 0; see world-delta.h. */
+  char *parentName; /* If a delta, else NULL. */
+  objptr signalHandlerThread;
+  pointer start;
+  size_t textSize; /* With its '\000'. */
+};
+
+/* The file of the loaded world, if its heap image is mapped. */
+struct GC_mappedWorld {
+  dev_t dev;
+  ino_t ino;
+  bool mapped;
+};
+
+#endif /* (defined (MLTON_GC_INTERNAL_TYPES)) */
+
 #if (defined (MLTON_GC_INTERNAL_FUNCS))
 
-static void loadWorldFromFILE (GC_state s, FILE *f);
+static inline size_t sizeofWorldHeader (size_t textSize, const char *parentName);
+static void readWorldHeader (GC_state s, FILE *f, struct GC_worldHeader *h);
+static void skipWorldBytes (FILE *f, uintmax_t n);
+static void skipWorldPadding (FILE *f, struct GC_worldHeader *h);
+static void readWorldImage (GC_state s, FILE *f, struct GC_worldHeader *h);
+static bool mapWorldHeap (GC_state s, FILE *f, pointer start, uintmax_t offset,
+                          bool relocatable);
+static void loadWorldFromFILE (GC_state s, FILE *f, const char *fileName);
 static void loadWorldFromFileName (GC_state s, const char *fileName);
-static int saveWorldToFILE (GC_state s, FILE *f);
+static int saveWorldToFILE (GC_state s, FILE *f, const char *fileName, bool delta);
 
 #endif /* (defined (MLTON_GC_INTERNAL_FUNCS)) */
 
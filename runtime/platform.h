@@ -131,10 +131,48 @@ PRIVATE void *GC_mmapAnon_safe_protect (void *start, size_t length,
                                          size_t dead_low, size_t dead_high);
 PRIVATE void *GC_mremap (void *start, size_t oldLength, size_t newLength);
 PRIVATE void GC_release (void *base, size_t length);
+/* GC_discard gives the pages of [base, base + length) back to the OS
+ * but keeps them mapped, so that reading them afterwards yields zeros
+ * or, if lazily, possibly their old contents.  Returns FALSE if the
+ * pages were not given back.
+ */
+PRIVATE bool GC_discard (void *base, size_t length, bool lazily);
+
+/* Huge pages, reservations, and NUMA placement; see memPolicy.linux.c.
+ * GC_reserve maps pages that cannot be accessed until GC_commit makes
+ * them readable and writable; GC_decommit makes them inaccessible
+ * again.  Where they are not supported, GC_hugePageSize returns 0,
+ * GC_mmapAnonHuge and GC_reserve return (void*)-1, and the others
+ * return FALSE or do nothing.
+ */
+PRIVATE size_t GC_hugePageSize (void);
+PRIVATE void *GC_mmapAnonHuge (void *start, size_t length);
+PRIVATE void *GC_reserve (void *start, size_t length);
+PRIVATE bool GC_commit (void *base, size_t length);
+PRIVATE void GC_decommit (void *base, size_t length);
+PRIVATE bool GC_adviseHugePages (void *start, size_t length);
+PRIVATE bool GC_setNumaPolicy (void *start, size_t length, bool interleave);
+PRIVATE void GC_displayMemPages (FILE *stream, void *start);
+/* GC_mapFile maps length bytes of fd, from offset, copy-on-write at
+ * start, over the pages mapped there.  It returns (void*)-1, with the
+ * pages at start left as they were, if it cannot.
+ */
+PRIVATE void *GC_mapFile (void *start, size_t length, int fd, uintmax_t offset);
+/* GC_mapShared creates the file name in /dev/shm, of length bytes,
+ * and maps it shared, readable and writable.  It returns (void*)-1 if
+ * it cannot.  GC_unmapShared unmaps it and removes the file.
+ */
+PRIVATE void *GC_mapShared (const char *name, size_t length);
+PRIVATE void GC_unmapShared (const char *name, void *start, size_t length);
 
 PRIVATE size_t GC_pageSize (void);
 PRIVATE uintmax_t GC_physMem (void);
 
+/* GC_getMonotonicTime returns the time of a monotonic clock, where
+ * there is one, as a number of microseconds.
+ */
+PRIVATE uintmax_t GC_getMonotonicTime (void);
+
 PRIVATE void GC_setCygwinUseMmap (bool b);
 
 PRIVATE void GC_diskBack_close (void *data);
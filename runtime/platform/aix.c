@@ -5,7 +5,9 @@
 #include <sys/vminfo.h>
 
 #include "diskBack.unix.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.gettimeofday.c"
 #include "nonwin.c"
 #include "recv.nonblock.c"
 #include "use-mmap.c"
@@ -3,7 +3,9 @@
 #include "platform.h"
 
 #include "mmap.c"
+#include "memPolicy.none.c"
 #if not HAS_MSG_DONTWAIT
+#include "monotonicTime.gettimeofday.c"
 #include "recv.nonblock.c"
 #endif
 #include "windows.c"
@@ -84,6 +86,13 @@ void GC_release (void *base, size_t length) {
                 Windows_release (base, length);
 }
 
+bool GC_discard (void *base, size_t length, bool lazily) {
+        if (MLton_Platform_CygwinUseMmap)
+                return madviseDiscard (base, length, lazily);
+        else
+                return Windows_discard (base, length, lazily);
+}
+
 void* GC_extendHead (void *base, size_t length) {
         if (MLton_Platform_CygwinUseMmap)
                 return mmapAnon (base, length);
@@ -11,6 +11,7 @@
 #include <netinet/tcp.h>
 #include <netinet/udp.h>
 #include <process.h>
+#include <pthread.h>
 #include <pwd.h>
 #include <sys/cygwin.h>
 #include <sys/ioctl.h>
@@ -4,7 +4,9 @@
 #include <stdio.h>
 
 #include "diskBack.unix.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.gettimeofday.c"
 #include "nonwin.c"
 #include "sysctl.c"
 #include "use-mmap.c"
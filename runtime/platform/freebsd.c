@@ -1,7 +1,9 @@
 #include "platform.h"
 
 #include "diskBack.unix.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.clock.c"
 #include "nonwin.c"
 #include "sysctl.c"
 #include "use-mmap.c"
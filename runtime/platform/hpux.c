@@ -8,7 +8,9 @@
 #define MAP_ANON MAP_ANONYMOUS
 
 #include "diskBack.unix.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.gettimeofday.c"
 #include "nonwin.c"
 #include "recv.nonblock.c"
 #include "setenv.putenv.c"
@@ -4,7 +4,9 @@
 
 #include "diskBack.unix.c"
 #include "displayMem.proc.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.gettimeofday.c"
 #include "nonwin.c"
 #include "use-mmap.c"
 #include "sysconf.c"
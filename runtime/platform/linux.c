@@ -4,7 +4,14 @@
 
 #include "diskBack.unix.c"
 #include "displayMem.proc.c"
+#include "memPolicy.linux.c"
 #include "mmap-protect.c"
+/* Before 2.17, glibc has clock_gettime only in -lrt. */
+#if defined (__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 17))
+#include "monotonicTime.gettimeofday.c"
+#else
+#include "monotonicTime.clock.c"
+#endif
 #include "nonwin.c"
 #include "use-mmap.c"
 
@@ -0,0 +1,185 @@
+#include <sys/syscall.h>
+
+/* As for MREMAP_MAYMOVE in linux.c, the following may be missing
+ * from older system headers, and come from the kernel's.
+ */
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+#ifndef MPOL_LOCAL
+#define MPOL_LOCAL 4
+#endif
+#ifndef MPOL_F_MEMS_ALLOWED
+#define MPOL_F_MEMS_ALLOWED (1 << 2)
+#endif
+
+size_t GC_hugePageSize (void) {
+        FILE *f;
+        char line[256];
+        unsigned long kb;
+        size_t res;
+
+        res = 0;
+        f = fopen ("/proc/meminfo", "r");
+        if (NULL == f)
+                return 0;
+        while (NULL != fgets (line, sizeof (line), f))
+                if (1 == sscanf (line, "Hugepagesize: %lu kB", &kb)) {
+                        res = (size_t)kb * 1024;
+                        break;
+                }
+        fclose (f);
+        return res;
+}
+
+void *GC_mmapAnonHuge (void *start, size_t length) {
+        return mmap (start, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+}
+
+/* With MAP_NORESERVE, the reservation is not charged against the
+ * overcommit limit; the pages are charged as they are committed.
+ */
+void *GC_reserve (void *start, size_t length) {
+        return mmap (start, length, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+}
+
+bool GC_commit (void *base, size_t length) {
+        return 0 == length
+                or 0 == mprotect (base, length, PROT_READ | PROT_WRITE);
+}
+
+void GC_decommit (void *base, size_t length) {
+        if (0 == length)
+                return;
+        if (0 != mprotect (base, length, PROT_NONE))
+                diee ("mprotect failed");
+}
+
+bool GC_adviseHugePages (void *start, size_t length) {
+        return 0 == madvise (start, length, MADV_HUGEPAGE);
+}
+
+bool GC_setNumaPolicy (void *start, size_t length, bool interleave) {
+        unsigned long nodes[16];
+
+        if (interleave) {
+                memset (nodes, 0, sizeof (nodes));
+                if (0 != syscall (SYS_get_mempolicy, NULL, nodes,
+                                  8 * sizeof (nodes), NULL, MPOL_F_MEMS_ALLOWED))
+                        return FALSE;
+                return 0 == syscall (SYS_mbind, start, length, MPOL_INTERLEAVE,
+                                     nodes, 8 * sizeof (nodes), 0);
+        }
+        if (0 == syscall (SYS_mbind, start, length, MPOL_LOCAL, NULL, 0, 0))
+                return TRUE;
+        /* Before Linux 3.8, an empty preferred set means the local node. */
+        return 0 == syscall (SYS_mbind, start, length, MPOL_PREFERRED, NULL, 0, 0);
+}
+
+/* Display what the kernel reports for the pages of the mapping that
+ * holds start: its page size and huge pages from /proc/self/smaps, and
+ * its NUMA policy and the nodes of its pages from /proc/self/numa_maps.
+ */
+void GC_displayMemPages (FILE *stream, void *start) {
+        FILE *f;
+        char line[1024];
+        unsigned long low;
+        bool found;
+
+        f = fopen ("/proc/self/smaps", "r");
+        if (NULL == f)
+                return;
+        found = FALSE;
+        low = 0;
+        while (NULL != fgets (line, sizeof (line), f)) {
+                unsigned long l, h;
+
+                if (2 == sscanf (line, "%lx-%lx ", &l, &h)) {
+                        if (found)
+                                break;
+                        found = (l <= (unsigned long)start and (unsigned long)start < h);
+                        if (found)
+                                low = l;
+                } else if (found
+                           and (0 == strncmp (line, "Rss:", 4)
+                                or 0 == strncmp (line, "AnonHugePages:", 14)
+                                or 0 == strncmp (line, "Private_Hugetlb:", 16)
+                                or 0 == strncmp (line, "KernelPageSize:", 15)
+                                or 0 == strncmp (line, "THPeligible:", 12)))
+                        fprintf (stream, "\t%s", line);
+        }
+        fclose (f);
+        unless (found)
+                return;
+        f = fopen ("/proc/self/numa_maps", "r");
+        if (NULL == f)
+                return;
+        while (NULL != fgets (line, sizeof (line), f)) {
+                unsigned long l;
+
+                if (1 == sscanf (line, "%lx ", &l) and l == low) {
+                        fprintf (stream, "\tnuma_maps: %s", line);
+                        break;
+                }
+        }
+        fclose (f);
+}
+
+/* A MAP_FIXED mmap that fails may have unmapped the pages at start
+ * already, so the file is first mapped elsewhere, which fails in the
+ * same way if the file system cannot map it.
+ */
+void *GC_mapFile (void *start, size_t length, int fd, uintmax_t offset) {
+        void *probe;
+
+        if ((uintmax_t)(off_t)offset != offset)
+                return (void*)-1;
+        probe = mmap (NULL, length, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (MAP_FAILED == probe)
+                return (void*)-1;
+        munmap (probe, length);
+        return mmap (start, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, (off_t)offset);
+}
+
+void *GC_mapShared (const char *name, size_t length) {
+        char path[PATH_MAX];
+        void *res;
+        int fd;
+
+        if ((size_t)snprintf (path, sizeof (path), "/dev/shm/%s", name)
+            >= sizeof (path))
+                return (void*)-1;
+        fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+                return (void*)-1;
+        res = (0 == ftruncate (fd, (off_t)length))
+              ? mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+              : MAP_FAILED;
+        close (fd);
+        if (MAP_FAILED == res) {
+                unlink (path);
+                return (void*)-1;
+        }
+        return res;
+}
+
+void GC_unmapShared (const char *name, void *start, size_t length) {
+        char path[PATH_MAX];
+
+        munmap (start, length);
+        if ((size_t)snprintf (path, sizeof (path), "/dev/shm/%s", name)
+            < sizeof (path))
+                unlink (path);
+}
@@ -0,0 +1,54 @@
+size_t GC_hugePageSize (void) {
+        return 0;
+}
+
+void *GC_mmapAnonHuge (__attribute__ ((unused)) void *start,
+                       __attribute__ ((unused)) size_t length) {
+        return (void*)-1;
+}
+
+void *GC_reserve (__attribute__ ((unused)) void *start,
+                  __attribute__ ((unused)) size_t length) {
+        return (void*)-1;
+}
+
+bool GC_commit (__attribute__ ((unused)) void *base,
+                __attribute__ ((unused)) size_t length) {
+        return FALSE;
+}
+
+void GC_decommit (__attribute__ ((unused)) void *base,
+                  __attribute__ ((unused)) size_t length) {
+}
+
+bool GC_adviseHugePages (__attribute__ ((unused)) void *start,
+                         __attribute__ ((unused)) size_t length) {
+        return FALSE;
+}
+
+bool GC_setNumaPolicy (__attribute__ ((unused)) void *start,
+                       __attribute__ ((unused)) size_t length,
+                       __attribute__ ((unused)) bool interleave) {
+        return FALSE;
+}
+
+void GC_displayMemPages (__attribute__ ((unused)) FILE *stream,
+                         __attribute__ ((unused)) void *start) {
+}
+
+void *GC_mapFile (__attribute__ ((unused)) void *start,
+                  __attribute__ ((unused)) size_t length,
+                  __attribute__ ((unused)) int fd,
+                  __attribute__ ((unused)) uintmax_t offset) {
+        return (void*)-1;
+}
+
+void *GC_mapShared (__attribute__ ((unused)) const char *name,
+                    __attribute__ ((unused)) size_t length) {
+        return (void*)-1;
+}
+
+void GC_unmapShared (__attribute__ ((unused)) const char *name,
+                     __attribute__ ((unused)) void *start,
+                     __attribute__ ((unused)) size_t length) {
+}
@@ -2,6 +2,8 @@
 
 #include "platform.h"
 
+#include "memPolicy.none.c"
+#include "monotonicTime.gettimeofday.c"
 #include "windows.c"
 #include "mremap.c"
 
@@ -13,6 +15,10 @@ void GC_release (void *base, size_t length) {
         Windows_release (base, length);
 }
 
+bool GC_discard (void *base, size_t length, bool lazily) {
+        return Windows_discard (base, length, lazily);
+}
+
 void *GC_extendHead (void *base, size_t length) {
         return Windows_mmapAnon (base, length);
 }
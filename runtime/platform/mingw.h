@@ -23,6 +23,7 @@
 #include <io.h>
 #include <lm.h>
 #include <process.h>
+#include <pthread.h>
 //#include <psapi.h>
 #include <ws2tcpip.h>
 #include <psapi.h>
@@ -3,6 +3,20 @@ static inline void *mmapAnon (void *start, size_t length) {
                         MAP_PRIVATE | MAP_ANON, -1, 0);
 }
 
+/* MADV_FREE, where available, lets the OS take the pages only when it
+ * needs them; it is not supported before Linux 4.5 nor for huge pages.
+ */
+static inline bool madviseDiscard (void *base, size_t length,
+                                   __attribute__ ((unused)) bool lazily) {
+        if (0 == length)
+                return TRUE;
+#ifdef MADV_FREE
+        if (lazily and 0 == madvise (base, length, MADV_FREE))
+                return TRUE;
+#endif
+        return 0 == madvise (base, length, MADV_DONTNEED);
+}
+
 static void munmap_safe (void *base, size_t length) {
         assert (base != NULL);
         if (0 == length)
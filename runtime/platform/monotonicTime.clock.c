@@ -0,0 +1,18 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* GC_getMonotonicTime falls back to the time of day if the monotonic
+ * clock is not supported by the kernel.
+ */
+uintmax_t GC_getMonotonicTime (void) {
+        struct timespec ts;
+        struct timeval tv;
+
+        if (0 == clock_gettime (CLOCK_MONOTONIC, &ts))
+                return 1000000 * (uintmax_t)ts.tv_sec + (uintmax_t)ts.tv_nsec / 1000;
+        gettimeofday (&tv, (struct timezone*)NULL);
+        return 1000000 * (uintmax_t)tv.tv_sec + (uintmax_t)tv.tv_usec;
+}
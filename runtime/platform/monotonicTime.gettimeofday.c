@@ -0,0 +1,15 @@
+/* Copyright (C) 2026 MLton contributors.
+ *
+ * MLton is released under a BSD-style license.
+ * See the file MLton-LICENSE for details.
+ */
+
+/* Where clock_gettime is missing, or needs a library that is not
+ * linked, the time of day stands in for a monotonic clock.
+ */
+uintmax_t GC_getMonotonicTime (void) {
+        struct timeval tv;
+
+        gettimeofday (&tv, (struct timezone*)NULL);
+        return 1000000 * (uintmax_t)tv.tv_sec + (uintmax_t)tv.tv_usec;
+}
@@ -2,7 +2,9 @@
 
 #include "diskBack.unix.c"
 #include "displayMem.proc.c"
+#include "memPolicy.none.c"
 #include "mmap-protect.c"
+#include "monotonicTime.clock.c"
 #include "nonwin.c"
 #include "sysctl.c"
 #include "use-mmap.c"
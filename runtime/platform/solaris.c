@@ -4,8 +4,10 @@
 
 #include "diskBack.unix.c"
 #include "float-math.c"
+#include "memPolicy.none.c"
 #include "mmap.c"
 #include "mmap-protect.c"
+#include "monotonicTime.clock.c"
 #include "nonwin.c"
 #include "sysconf.c"
 #include "setenv.putenv.c"
@@ -75,3 +77,7 @@ void *GC_mmapAnon (void *start, size_t length) {
 void GC_release (void *base, size_t length) {
         munmap_safe (base, length);
 }
+
+bool GC_discard (void *base, size_t length, bool lazily) {
+        return madviseDiscard (base, length, lazily);
+}
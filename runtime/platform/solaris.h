@@ -10,6 +10,7 @@
 #include <netinet/tcp.h>
 #include <netinet/udp.h>
 #include <poll.h>
+#include <pthread.h>
 #include <pwd.h>
 #include <strings.h>
 #include <sys/filio.h> /* For FIONBIO, FIONREAD. */
@@ -7,3 +7,7 @@ void GC_release (void *base, size_t length) {
 void *GC_mmapAnon (void *start, size_t length) {
         return mmapAnon (start, length);
 }
+
+bool GC_discard (void *base, size_t length, bool lazily) {
+        return madviseDiscard (base, length, lazily);
+}
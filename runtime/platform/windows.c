@@ -302,6 +302,19 @@ static inline void Windows_release (void *base, size_t length) {
         /* The last release also handled the optional MEM_RESERVE region */
 }
 
+/* MEM_RESET lets the OS take the pages only when it needs them;
+ * otherwise, they are decommitted and committed again as zeros.
+ */
+static inline bool Windows_discard (void *base, size_t length, bool lazily) {
+        if (0 == length)
+                return TRUE;
+        if (lazily)
+                return NULL != VirtualAlloc (base, length, MEM_RESET, PAGE_READWRITE);
+        if (0 == VirtualFree (base, length, MEM_DECOMMIT))
+                return FALSE;
+        return NULL != VirtualAlloc (base, length, MEM_COMMIT, PAGE_READWRITE);
+}
+
 /* Extend an existing heap */
 static inline void* Windows_extend (void *base, size_t length) {
         MEMORY_BASIC_INFORMATION mi;